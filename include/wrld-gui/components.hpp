@@ -10,9 +10,11 @@
 #include <wrld/components/Environment.hpp>
 #include <wrld/components/FPSControl.hpp>
 #include <wrld/components/Orbiter.hpp>
+#include <wrld/components/Parent.hpp>
 #include <wrld/components/PointLight.hpp>
 #include <wrld/components/StaticModel.hpp>
 #include <wrld/components/Transform.hpp>
+#include <wrld/tags.hpp>
 
 #include <imgui.h>
 #include <map>
@@ -95,12 +97,11 @@ namespace wrld::gui {
                     ImGui::Text("Current mode: ENTITY");
 
                     // Allow to change tracked entity at runtime
-                    std::vector<EntityID> entities_id;
-                    entities_id.reserve(world.get_entities().size());
+                    const std::span<const EntityID> entities_id = world.get_entities();
                     std::string names = {};
-                    for (const auto &[id, name]: world.get_entities()) {
-                        entities_id.push_back(id);
-                        names += name + '\0';
+                    for (const EntityID id: entities_id) {
+                        names += world.get_entity_name(id);
+                        names += '\0';
                     }
                     names += '\0';
                     static int current_item_idx = std::ranges::find(entities_id, tracked_id) - entities_id.begin();
@@ -144,6 +145,15 @@ namespace wrld::gui {
         }
     }
 
+    template<>
+    inline void component_menu<cpt::Parent>(World &world, const EntityID &entity) {
+        const auto &cpt = world.get_component<cpt::Parent>(entity);
+        if (ImGui::TreeNode(cpt->get_type().c_str())) {
+            ImGui::Text("Parent: %s", world.get_entity_name(cpt->get_parent()).c_str());
+            ImGui::TreePop();
+        }
+    }
+
     template<>
     inline void component_menu<cpt::PointLight>(World &world, const EntityID &entity) {
         const auto &cpt = world.get_component<cpt::PointLight>(entity);
@@ -191,6 +201,7 @@ namespace wrld::gui {
             {typeid(cpt::Environment), &component_menu<cpt::Environment>},
             {typeid(cpt::FPSControl), &component_menu<cpt::FPSControl>},
             {typeid(cpt::Orbiter), &component_menu<cpt::Orbiter>},
+            {typeid(cpt::Parent), &component_menu<cpt::Parent>},
             {typeid(cpt::PointLight), &component_menu<cpt::PointLight>},
             {typeid(cpt::StaticModel), &component_menu<cpt::StaticModel>},
             {typeid(cpt::Transform), &component_menu<cpt::Transform>}};
@@ -0,0 +1,85 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#pragma once
+
+#include <wrld/Entity.hpp>
+#include <wrld/TypeId.hpp>
+#include <wrld/concepts.hpp>
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wrld {
+    class World;
+
+    /// Records structural changes (entity creation/deletion, component attachment/detachment, tags)
+    /// to apply them later, in one batch, with World::flush_commands.
+    /// This allows to mutate the World while iterating over it, and recording is thread-safe
+    /// so systems running in parallel can queue their changes.
+    ///
+    /// Commands are applied in recording order. Component storages are grown once per flush for all their
+    /// attachments. Commands targeting an entity that no longer exists are ignored, and a command failing
+    /// is reported without preventing the others from being applied.
+    class CommandBuffer {
+    public:
+        explicit CommandBuffer(World &world);
+
+        CommandBuffer(const CommandBuffer &other) = delete;
+        CommandBuffer &operator=(const CommandBuffer &other) = delete;
+
+        /// Reserve a new Entity, created on flush. The returned ID can already be used in
+        /// other commands, but the entity does not exist in the World before the flush.
+        EntityID create_entity(const std::string &name = "");
+
+        /// Delete the entity on flush.
+        void delete_entity(EntityID id);
+
+        /// Attach a component of type C on flush. The arguments are copied (or moved) now.
+        template<ComponentConcept C, typename... Args>
+        void attach_component(EntityID id, Args &&...args);
+
+        /// Detach the component of type C on flush.
+        template<ComponentConcept C>
+        void detach_component(EntityID id);
+
+        /// Add the tag T on flush, with the attachments.
+        template<TagConcept T>
+        void add_tag(EntityID id);
+
+        /// Remove the tag T on flush, with the detachments.
+        template<TagConcept T>
+        void remove_tag(EntityID id);
+
+        /// Returns true if no command is waiting to be applied.
+        [[nodiscard]] bool empty() const;
+
+        /// Apply every recorded command. Must be called from the thread owning the World,
+        /// while nothing iterates over it.
+        void flush();
+
+    private:
+        struct Command {
+            TypeId type_id;
+            EntityID entity;
+            std::move_only_function<void()> apply;
+            // Prepares the component storage of type_id for the given amount of new components
+            void (*reserve)(World &world, size_t count);
+        };
+
+        World &world;
+
+        mutable std::mutex mutex;
+        std::vector<Command> commands;
+
+        void push(Command command);
+
+        template<ComponentConcept C>
+        static void reserve_storage(World &world, size_t count);
+    };
+} // namespace wrld
+
+#include <wrld/CommandBuffer.tpp>
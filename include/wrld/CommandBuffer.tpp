@@ -0,0 +1,54 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#pragma once
+
+#include <wrld/CommandBuffer.hpp>
+#include <wrld/World.hpp>
+
+#include <tuple>
+#include <utility>
+
+namespace wrld {
+    template<ComponentConcept C, typename... Args>
+    void CommandBuffer::attach_component(const EntityID id, Args &&...args) {
+        push(Command{component_type_id<C>(), id,
+                     [&world = world, id, args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                         if (!world.entity_exists(id))
+                             return;
+                         std::apply(
+                                 [&](auto &&...a) {
+                                     world.attach_component<C>(id, std::forward<decltype(a)>(a)...);
+                                 },
+                                 std::move(args));
+                     },
+                     &reserve_storage<C>});
+    }
+
+    template<ComponentConcept C>
+    void CommandBuffer::detach_component(const EntityID id) {
+        push(Command{component_type_id<C>(), id, [&world = world, id] { world.detach_component<C>(id); }, nullptr});
+    }
+
+    template<TagConcept T>
+    void CommandBuffer::add_tag(const EntityID id) {
+        push(Command{tag_type_id<T>(), id,
+                     [&world = world, id] {
+                         if (world.entity_exists(id))
+                             world.add_tag<T>(id);
+                     },
+                     nullptr});
+    }
+
+    template<TagConcept T>
+    void CommandBuffer::remove_tag(const EntityID id) {
+        push(Command{tag_type_id<T>(), id, [&world = world, id] { world.remove_tag<T>(id); }, nullptr});
+    }
+
+    template<ComponentConcept C>
+    void CommandBuffer::reserve_storage(World &world, const size_t count) {
+        auto &storage = world.get_or_create_storage<C>();
+        storage.reserve(storage.size() + count);
+    }
+} // namespace wrld
@@ -0,0 +1,42 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/concepts.hpp>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace wrld {
+    /// Non-owning handle to a component stored in a World.
+    /// Components live in the storage of their type, at a stable address: the handle stays valid
+    /// until the component is detached or its entity deleted. It does not keep the component alive.
+    /// Keep the EntityID instead if the component may be detached in the meantime.
+    template<typename C>
+    class ComponentRef {
+    public:
+        ComponentRef() = default;
+
+        explicit ComponentRef(C *component) : component(component) {}
+
+        /// ComponentRef<C> converts to ComponentRef<const C>.
+        template<typename D>
+            requires std::is_convertible_v<D *, C *>
+        ComponentRef(const ComponentRef<D> &other) : component(other.get()) {}
+
+        C *operator->() const { return component; }
+
+        C &operator*() const { return *component; }
+
+        [[nodiscard]] C *get() const { return component; }
+
+        explicit operator bool() const { return component != nullptr; }
+
+        bool operator==(const ComponentRef &other) const = default;
+
+    private:
+        C *component = nullptr;
+    };
+} // namespace wrld
@@ -0,0 +1,176 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#pragma once
+
+#include <wrld/Entity.hpp>
+#include <wrld/TypeId.hpp>
+#include <wrld/concepts.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <typeindex>
+#include <vector>
+
+namespace wrld {
+    class World;
+
+    /// Logical time of a World, used for change detection. Tick 0 is before anything happened.
+    typedef uint64_t Tick;
+
+    /// Type-erased part of a ComponentStorage.
+    /// Implements a sparse set: a paged sparse array maps each entity index to a position
+    /// in the dense arrays, so lookups are O(1) without hashing and iteration
+    /// only walks the entities that actually have the component.
+    /// The dense array stores full EntityIDs, so stale handles are never matched.
+    ///
+    /// Each component records the tick at which it was added and last changed,
+    /// so that systems can only process what was modified since they last ran.
+    class ComponentStorageBase {
+    public:
+        /// clock is the current tick of the World, read when components are added or changed.
+        ComponentStorageBase(std::type_index type, const std::atomic<Tick> &clock);
+
+        virtual ~ComponentStorageBase() = default;
+
+        ComponentStorageBase(const ComponentStorageBase &other) = delete;
+        ComponentStorageBase &operator=(const ComponentStorageBase &other) = delete;
+
+        /// Returns true if the entity has a component in this storage.
+        [[nodiscard]] bool contains(EntityID id) const;
+
+        /// Amount of components stored.
+        [[nodiscard]] size_t size() const;
+
+        /// Entities owning a component in this storage, in dense order.
+        [[nodiscard]] const std::vector<EntityID> &get_entities() const;
+
+        /// Type of the components stored.
+        [[nodiscard]] std::type_index get_type() const;
+
+        /// Record that the component of the entity was modified at the current tick.
+        /// Does nothing if the entity has no component in this storage.
+        void mark_changed(EntityID id);
+
+        /// Returns true if the entity has a component added after the given tick.
+        [[nodiscard]] bool added_since(EntityID id, Tick since) const;
+
+        /// Returns true if the entity has a component added or changed after the given tick.
+        [[nodiscard]] bool changed_since(EntityID id, Tick since) const;
+
+        /// Tick of the last modification of the storage: a component was added, changed or removed.
+        [[nodiscard]] Tick get_last_change() const;
+
+        /// Return the component of the entity, or nullptr.
+        [[nodiscard]] virtual Component *find_component(EntityID id) = 0;
+
+        /// Remove the component of the entity, if any.
+        virtual void remove(EntityID id) = 0;
+
+        /// Pre-allocate the dense arrays for the given amount of components.
+        virtual void reserve(size_t capacity) = 0;
+
+    protected:
+        static constexpr size_t PAGE_SIZE = 4096;
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        typedef std::array<uint32_t, PAGE_SIZE> SparsePage;
+
+        std::type_index type;
+
+        const std::atomic<Tick> &clock;
+        // Atomic as components may be changed from several threads (see View::par_each)
+        std::atomic<Tick> last_change = 0;
+
+        // Sparse array (split in pages to stay small with scattered IDs): entity index -> position in dense arrays.
+        std::vector<std::unique_ptr<SparsePage>> sparse;
+
+        // Dense array of entities. Components are stored at the same position in the derived storage.
+        std::vector<EntityID> dense;
+
+        // Ticks at which each component was added and last changed, parallel to dense.
+        std::vector<Tick> added_ticks;
+        std::vector<Tick> changed_ticks;
+
+        /// Return the dense position of the entity, or NONE.
+        [[nodiscard]] size_t dense_index(EntityID id) const;
+
+        /// Sparse array slot of the entity index. Its page must exist.
+        uint32_t &sparse_slot(EntityIndex index);
+
+        /// Pre-allocate the entity and tick arrays.
+        void reserve_entities(size_t capacity);
+
+        /// Register the entity at the end of the dense array and return its position.
+        size_t push_entity(EntityID id);
+
+        /// Swap-remove the entity from the dense array. Returns the position it was at,
+        /// which is now occupied by the previous last entity (if any).
+        size_t pop_entity(EntityID id);
+    };
+
+    /// Storage for every component of type C.
+    /// Components are constructed in place in slabs (large blocks of memory holding many of them),
+    /// so they are not allocated one by one and never move: their address is stable until removal.
+    /// Free slots are reused by the next components.
+    template<ComponentConcept C>
+    class ComponentStorage final : public ComponentStorageBase {
+    public:
+        /// Amount of components per slab.
+        static constexpr size_t SLAB_CAPACITY = std::max<size_t>(1, 64 * 1024 / sizeof(C));
+
+        explicit ComponentStorage(const std::atomic<Tick> &clock);
+
+        ~ComponentStorage() override;
+
+        /// Construct a component for the entity. The entity must not already have one.
+        template<typename... Args>
+        C &emplace(EntityID id, World &world, Args &&...args);
+
+        /// Construct a component for each entity, in consecutive slots.
+        /// make_args(i) returns the tuple of constructor arguments of the i-th component.
+        /// The entities must not already have one.
+        template<typename MakeArgs>
+        void emplace_batch(std::span<const EntityID> ids, World &world, MakeArgs &&make_args);
+
+        /// Return a pointer to the component of the entity, or nullptr.
+        [[nodiscard]] C *find(EntityID id);
+
+        /// Components in dense order, matching get_entities().
+        [[nodiscard]] const std::vector<C *> &get_components() const;
+
+        [[nodiscard]] Component *find_component(EntityID id) override;
+
+        void remove(EntityID id) override;
+
+        void reserve(size_t capacity) override;
+
+    private:
+        struct Slab {
+            alignas(C) std::byte data[SLAB_CAPACITY * sizeof(C)];
+        };
+
+        std::vector<std::unique_ptr<Slab>> slabs;
+        // Slots never used yet in the last slab
+        size_t last_slab_used = SLAB_CAPACITY;
+        // Slots of removed components
+        std::vector<C *> free_slots;
+
+        // Components, parallel to the dense array of entities
+        std::vector<C *> components;
+
+        /// Return uninitialised memory for a component.
+        C *allocate_slot();
+    };
+
+    // Storages of a World, indexed by the TypeId of the stored component type (see component_type_id).
+    typedef std::vector<std::unique_ptr<ComponentStorageBase>> ComponentPool;
+} // namespace wrld
+
+#include <wrld/ComponentStorage.tpp>
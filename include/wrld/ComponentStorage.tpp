@@ -0,0 +1,137 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#pragma once
+
+#include <wrld/ComponentStorage.hpp>
+
+#include <memory>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+
+namespace wrld {
+    template<ComponentConcept C>
+    ComponentStorage<C>::ComponentStorage(const std::atomic<Tick> &clock) :
+        ComponentStorageBase(std::type_index(typeid(C)), clock) {}
+
+    template<ComponentConcept C>
+    ComponentStorage<C>::~ComponentStorage() {
+        for (C *component: components)
+            std::destroy_at(component);
+    }
+
+    template<ComponentConcept C>
+    template<typename... Args>
+    C &ComponentStorage<C>::emplace(const EntityID id, World &world, Args &&...args) {
+        C *slot = allocate_slot();
+
+        // Construct first: if the constructor throws, the storage is left untouched
+        try {
+            const TypeConstructionScope<Component> scope(component_type_id<C>());
+            std::construct_at(slot, id, world, std::forward<Args>(args)...);
+        } catch (...) {
+            free_slots.push_back(slot);
+            throw;
+        }
+
+        push_entity(id);
+        return *components.emplace_back(slot);
+    }
+
+    template<ComponentConcept C>
+    template<typename MakeArgs>
+    void ComponentStorage<C>::emplace_batch(const std::span<const EntityID> ids, World &world, MakeArgs &&make_args) {
+        reserve(size() + ids.size());
+
+        // Construct everything first: if a constructor throws, the storage is left untouched
+        std::vector<C *> constructed;
+        constructed.reserve(ids.size());
+        try {
+            const TypeConstructionScope<Component> scope(component_type_id<C>());
+            for (size_t i = 0; i < ids.size(); i++) {
+                C *slot = allocate_slot();
+                try {
+                    std::apply(
+                            [&](auto &&...args) {
+                                std::construct_at(slot, ids[i], world, std::forward<decltype(args)>(args)...);
+                            },
+                            make_args(i));
+                } catch (...) {
+                    free_slots.push_back(slot);
+                    throw;
+                }
+                constructed.push_back(slot);
+            }
+        } catch (...) {
+            for (C *slot: constructed) {
+                std::destroy_at(slot);
+                free_slots.push_back(slot);
+            }
+            throw;
+        }
+
+        for (size_t i = 0; i < ids.size(); i++) {
+            push_entity(ids[i]);
+            components.push_back(constructed[i]);
+        }
+    }
+
+    template<ComponentConcept C>
+    C *ComponentStorage<C>::find(const EntityID id) {
+        const size_t index = dense_index(id);
+        if (index == NONE)
+            return nullptr;
+        return components[index];
+    }
+
+    template<ComponentConcept C>
+    Component *ComponentStorage<C>::find_component(const EntityID id) {
+        return find(id);
+    }
+
+    template<ComponentConcept C>
+    const std::vector<C *> &ComponentStorage<C>::get_components() const {
+        return components;
+    }
+
+    template<ComponentConcept C>
+    void ComponentStorage<C>::remove(const EntityID id) {
+        if (!contains(id))
+            return;
+
+        // Mirror the swap-remove done on the entity array
+        const size_t index = pop_entity(id);
+        C *removed = components[index];
+        components[index] = components.back();
+        components.pop_back();
+
+        std::destroy_at(removed);
+        free_slots.push_back(removed);
+    }
+
+    template<ComponentConcept C>
+    void ComponentStorage<C>::reserve(const size_t capacity) {
+        reserve_entities(capacity);
+        components.reserve(capacity);
+    }
+
+    template<ComponentConcept C>
+    C *ComponentStorage<C>::allocate_slot() {
+        if (!free_slots.empty()) {
+            C *slot = free_slots.back();
+            free_slots.pop_back();
+            return slot;
+        }
+
+        if (last_slab_used == SLAB_CAPACITY) {
+            slabs.push_back(std::make_unique_for_overwrite<Slab>());
+            last_slab_used = 0;
+        }
+
+        C *slot = reinterpret_cast<C *>(slabs.back()->data) + last_slab_used;
+        last_slab_used += 1;
+        return slot;
+    }
+} // namespace wrld
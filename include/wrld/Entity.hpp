@@ -0,0 +1,37 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace wrld {
+    /// Handle of an Entity.
+    /// The lower 32 bits are the index of the entity slot, the upper 32 bits its generation.
+    /// Slots are recycled when entities are deleted: the generation is then incremented,
+    /// so handles to the deleted entity are detected as stale.
+    typedef size_t EntityID;
+
+    typedef uint32_t EntityIndex;
+    typedef uint32_t EntityGeneration;
+
+    /// Handle that never refers to an entity (index 0 is never given).
+    static constexpr EntityID NULL_ENTITY = 0;
+
+    /// Maximum amount of component and tag types in a program.
+    static constexpr size_t MAX_COMPONENT_TYPES = 64;
+
+    /// Set of the component types attached to an entity and of its tags, indexed by their TypeId.
+    typedef std::bitset<MAX_COMPONENT_TYPES> ComponentSignature;
+
+    constexpr EntityIndex entity_index(const EntityID id) { return static_cast<EntityIndex>(id & 0xFFFFFFFF); }
+
+    constexpr EntityGeneration entity_generation(const EntityID id) { return static_cast<EntityGeneration>(id >> 32); }
+
+    constexpr EntityID make_entity_id(const EntityIndex index, const EntityGeneration generation) {
+        return static_cast<EntityID>(generation) << 32 | index;
+    }
+} // namespace wrld
@@ -7,6 +7,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <chrono>
 #include <memory>
 
 #include <wrld/App.hpp>
@@ -31,13 +32,26 @@ namespace wrld {
 
         static void set_renderer_type(RendererType _renderer_type);
 
+        /// Set the time spent each frame destroying unused resources (see World::collect_unused_resources).
+        /// A zero budget disables the collection.
+        static void set_resource_collection_budget(std::chrono::microseconds budget);
+
+        /// Set the time and the amount of bytes spent each frame uploading the resources loaded in the background
+        /// (see ResourceLoader::upload).
+        static void set_upload_budget(std::chrono::microseconds time_budget, size_t byte_budget);
+
     private:
-        static World world;
+        static std::unique_ptr<World> world;
         static GLFWwindow *window;
         static std::shared_ptr<rsc::WindowFramebuffer> window_viewport;
 
         static RendererType renderer_type;
 
+        static std::chrono::microseconds resource_collection_budget;
+
+        static std::chrono::microseconds upload_time_budget;
+        static size_t upload_byte_budget;
+
         static bool should_close;
 
         // Deltatime computing
@@ -0,0 +1,144 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/ComponentStorage.hpp>
+#include <wrld/ThreadPool.hpp>
+#include <wrld/View.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace wrld {
+    class World;
+
+    /// Type-erased part of a Query: the list of matching entities, maintained by the World.
+    class QueryBase {
+    public:
+        virtual ~QueryBase() = default;
+
+        QueryBase(const QueryBase &other) = delete;
+        QueryBase &operator=(const QueryBase &other) = delete;
+
+        /// Entities matching the query, in no particular order.
+        [[nodiscard]] const std::vector<EntityID> &get_entities() const;
+
+        /// Amount of matching entities.
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] bool empty() const;
+
+        /// Component types every matched entity has.
+        [[nodiscard]] const ComponentSignature &get_required() const;
+
+    protected:
+        explicit QueryBase(ComponentSignature required);
+
+        std::vector<EntityID> entities;
+
+    private:
+        friend class World;
+
+        static constexpr uint32_t NO_POSITION = std::numeric_limits<uint32_t>::max();
+
+        ComponentSignature required;
+
+        // Position of each entity in the entities array, indexed by entity index.
+        std::vector<uint32_t> positions;
+
+        /// Add or remove the entity depending on its new signature. Called by the World
+        /// when a component type required by the query is attached to or detached from the entity.
+        void update(EntityID id, const ComponentSignature &signature);
+    };
+
+    /// Persistent query over every entity having all the required components, created by World::query.
+    /// Unlike a View, which finds its entities each time it is created, a Query keeps the list of matching
+    /// entities and the World updates it when a required component is attached or detached, or an
+    /// entity deleted. Iterating it costs no setup nor signature check: in steady state, only the components
+    /// of the matching entities are visited.
+    ///
+    /// Components wrapped in Optional<C> are supported. Added and Changed filters depend on a tick
+    /// and are not cached: use a View for them.
+    ///
+    /// The Query lives as long as its World. As for Views, structural changes while iterating
+    /// must go through World::commands.
+    template<typename... Cs>
+    class Query final : public QueryBase {
+        static_assert(sizeof...(Cs) > 0, "A Query needs at least one component");
+        static_assert((!ViewTraits<Cs>::OPTIONAL || ...), "A Query needs at least one non-optional component");
+        static_assert(((ViewTraits<Cs>::FILTER == NO_FILTER) && ...),
+                      "Queries do not support Added and Changed filters, use a View");
+
+    public:
+        typedef std::tuple<ComponentStorage<typename ViewTraits<Cs>::Component> *...> Storages;
+        typedef std::tuple<EntityID, typename ViewTraits<Cs>::Reference...> Item;
+
+        class Iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::ptrdiff_t difference_type;
+            typedef Item value_type;
+            typedef Item reference;
+
+            Iterator() = default;
+
+            Iterator(const Query *query, Storages storages, size_t position);
+
+            Item operator*() const;
+
+            Iterator &operator++();
+
+            Iterator operator++(int);
+
+            bool operator==(const Iterator &other) const;
+
+        private:
+            const Query *query = nullptr;
+            Storages storages;
+            size_t position = 0;
+        };
+
+        /// Amount of entities per task of par_each, if not specified.
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 1024;
+
+        /// components are the storages of the World, indexed by TypeId. thread_pool is used by par_each.
+        Query(const ComponentPool &components, ThreadPool &thread_pool);
+
+        [[nodiscard]] Iterator begin() const;
+
+        [[nodiscard]] Iterator end() const;
+
+        /// Call f(EntityID, components...) for each matching entity.
+        template<typename F>
+        void each(F &&f) const;
+
+        /// Call f(EntityID, components...) for each matching entity, in parallel.
+        /// The entities are split in chunks of chunk_size entities, distributed over the thread pool.
+        /// f must be safe to call concurrently on different entities.
+        template<typename F>
+        void par_each(F &&f, size_t chunk_size = DEFAULT_CHUNK_SIZE) const;
+
+    private:
+        const ComponentPool &components;
+        ThreadPool &thread_pool;
+
+        /// Storages of the queried types, nullptr for those not created yet.
+        /// Looked up once per iteration: storages are created on demand but never destroyed.
+        [[nodiscard]] Storages get_storages() const;
+
+        /// Components of the entity at the given position.
+        [[nodiscard]] Item get(const Storages &storages, size_t position) const;
+
+        /// Signature of the non-optional components.
+        static ComponentSignature required_signature();
+    };
+} // namespace wrld
+
+#include <wrld/Query.tpp>
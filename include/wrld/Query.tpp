@@ -0,0 +1,109 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/Query.hpp>
+
+#include <utility>
+
+namespace wrld {
+    template<typename... Cs>
+    Query<Cs...>::Iterator::Iterator(const Query *query, Storages storages, const size_t position) :
+        query(query), storages(std::move(storages)), position(position) {}
+
+    template<typename... Cs>
+    typename Query<Cs...>::Item Query<Cs...>::Iterator::operator*() const {
+        return query->get(storages, position);
+    }
+
+    template<typename... Cs>
+    typename Query<Cs...>::Iterator &Query<Cs...>::Iterator::operator++() {
+        position += 1;
+        return *this;
+    }
+
+    template<typename... Cs>
+    typename Query<Cs...>::Iterator Query<Cs...>::Iterator::operator++(int) {
+        Iterator res = *this;
+        ++*this;
+        return res;
+    }
+
+    template<typename... Cs>
+    bool Query<Cs...>::Iterator::operator==(const Iterator &other) const {
+        return position == other.position;
+    }
+
+    template<typename... Cs>
+    Query<Cs...>::Query(const ComponentPool &components, ThreadPool &thread_pool) :
+        QueryBase(required_signature()), components(components), thread_pool(thread_pool) {}
+
+    template<typename... Cs>
+    typename Query<Cs...>::Iterator Query<Cs...>::begin() const {
+        return Iterator(this, get_storages(), 0);
+    }
+
+    template<typename... Cs>
+    typename Query<Cs...>::Iterator Query<Cs...>::end() const {
+        return Iterator(this, Storages(), entities.size());
+    }
+
+    template<typename... Cs>
+    template<typename F>
+    void Query<Cs...>::each(F &&f) const {
+        const Storages storages = get_storages();
+        for (size_t position = 0; position < entities.size(); position++)
+            std::apply(f, get(storages, position));
+    }
+
+    template<typename... Cs>
+    template<typename F>
+    void Query<Cs...>::par_each(F &&f, const size_t chunk_size) const {
+        const Storages storages = get_storages();
+        thread_pool.parallel_for(entities.size(), chunk_size, [&](const size_t begin, const size_t end) {
+            for (size_t position = begin; position < end; position++)
+                std::apply(f, get(storages, position));
+        });
+    }
+
+    template<typename... Cs>
+    typename Query<Cs...>::Storages Query<Cs...>::get_storages() const {
+        const auto find = [this]<typename C>() -> ComponentStorage<C> * {
+            const TypeId type_id = component_type_id<C>();
+            if (type_id >= components.size())
+                return nullptr;
+            return static_cast<ComponentStorage<C> *>(components[type_id].get());
+        };
+        return Storages(find.template operator()<typename ViewTraits<Cs>::Component>()...);
+    }
+
+    template<typename... Cs>
+    typename Query<Cs...>::Item Query<Cs...>::get(const Storages &storages, const size_t position) const {
+        const EntityID id = entities[position];
+        const auto fetch = [id]<typename C>(ComponentStorage<typename ViewTraits<C>::Component> *storage) ->
+                typename ViewTraits<C>::Reference {
+                    if constexpr (ViewTraits<C>::OPTIONAL) {
+                        if (storage == nullptr)
+                            return nullptr;
+                        return storage->find(id);
+                    } else {
+                        // Matched entities have every required component
+                        return *storage->find(id);
+                    }
+                };
+
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return Item(id, fetch.template operator()<Cs>(std::get<I>(storages))...);
+        }(std::index_sequence_for<Cs...>{});
+    }
+
+    template<typename... Cs>
+    ComponentSignature Query<Cs...>::required_signature() {
+        ComponentSignature res;
+        ((ViewTraits<Cs>::OPTIONAL ? void() : void(res.set(component_type_id<typename ViewTraits<Cs>::Component>()))),
+         ...);
+        return res;
+    }
+} // namespace wrld
@@ -0,0 +1,63 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/ThreadPool.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace wrld {
+    class World;
+    class System;
+
+    /// Runs the systems of a World once per frame.
+    /// Two systems conflict if one writes components the other reads or writes (see SystemAccess).
+    /// Conflicting systems run in the order they were added, the others run in parallel on the
+    /// thread pool of the World. Systems pinned to the main thread run on the thread calling run().
+    class Scheduler {
+    public:
+        Scheduler(World &world, ThreadPool &thread_pool);
+
+        ~Scheduler();
+
+        Scheduler(const Scheduler &other) = delete;
+        Scheduler &operator=(const Scheduler &other) = delete;
+
+        /// Create a system of type S, constructed with the World and the given arguments.
+        template<typename S, typename... Args>
+        S &add_system(Args &&...args) {
+            auto system = std::make_unique<S>(world, std::forward<Args>(args)...);
+            S &res = *system;
+            add_system(std::move(system));
+            return res;
+        }
+
+        /// Add an already created system.
+        System &add_system(std::unique_ptr<System> system);
+
+        /// Run every system once, waiting for all of them to finish.
+        /// If a system throws, the other systems still run and the first exception is rethrown.
+        void run();
+
+        [[nodiscard]] const std::vector<std::unique_ptr<System>> &get_systems() const;
+
+    private:
+        World &world;
+        ThreadPool &thread_pool;
+
+        std::vector<std::unique_ptr<System>> systems;
+
+        // Dependency graph: systems that must wait for each system, and amount of systems each one waits for.
+        // Rebuilt when a system is added.
+        std::vector<std::vector<size_t>> dependents;
+        std::vector<size_t> dependency_counts;
+        bool graph_outdated = false;
+
+        void build_graph();
+    };
+} // namespace wrld
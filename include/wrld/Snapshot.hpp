@@ -0,0 +1,56 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/Entity.hpp>
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace wrld {
+    class World;
+
+    /// Binary save of a World, to restore a scene without rebuilding it (importing models, splitting them...).
+    ///
+    /// A snapshot contains the entity table (IDs, generations, names), the components of the builtin types
+    /// that do not depend on the window (Transform, Parent, StaticModel, PointLight, DirectionalLight) and the
+    /// resources they use: Models with their aggregated geometry, Materials and Textures (by file path).
+    /// Other components (cameras, controls, environment...) and tags are not saved and must be created after loading.
+    ///
+    /// The file is memory-mapped when loading. Entity tables, component records and model geometry are
+    /// stored as raw arrays, aligned so that they are restored with bulk copies straight from the mapping,
+    /// and models are uploaded to the GPU without going through Mesh resources. Textures are loaded in the
+    /// background (see Texture::set_texture_async): they use the default texture until they are uploaded.
+    ///
+    /// The format is native-endian and tied to the layout of the saved types: a snapshot is a cache
+    /// for a given build, not an exchange format. Its version is checked on load.
+    class Snapshot {
+    public:
+        /// "WRLD", read as a native-endian integer.
+        static constexpr uint32_t MAGIC = 0x444C5257;
+
+        /// Incremented on every change of the format.
+        static constexpr uint32_t VERSION = 1;
+
+        /// Write the entities, components and resources of the world to the given file.
+        /// Throws std::runtime_error if the file cannot be written.
+        static void save(World &world, const std::string &path);
+
+        /// Restore a snapshot in the given world, which must never have created an entity.
+        /// Entities keep their IDs. Throws std::runtime_error if the world already created entities, or if the
+        /// file cannot be read, is not a snapshot, was written by another version or is corrupted. The whole file
+        /// is checked before the world is changed: the world is left untouched when it throws.
+        static void load(World &world, const std::string &path);
+
+    private:
+        /// Check that the entity tables of a snapshot describe the same entities, so that they can be used
+        /// as is: every alive entity is at its position, every other index has none, and free indices are
+        /// unique and not alive. Throws std::runtime_error otherwise.
+        static void validate_entity_tables(std::span<const EntityGeneration> generations,
+                                           std::span<const uint32_t> positions, std::span<const EntityID> alive,
+                                           std::span<const EntityIndex> free);
+    };
+} // namespace wrld
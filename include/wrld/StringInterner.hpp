@@ -0,0 +1,50 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace wrld {
+    /// Dense integer identifying a string interned in a StringInterner.
+    typedef uint32_t NameID;
+
+    static constexpr NameID NO_NAME = std::numeric_limits<NameID>::max();
+
+    /// Stores each distinct string once, and identifies it with a NameID.
+    /// Comparing or hashing NameIDs is cheaper than comparing strings, and objects sharing
+    /// a name share its storage. Strings are never removed: their string_view stay valid
+    /// as long as the interner.
+    class StringInterner {
+    public:
+        StringInterner() = default;
+
+        // The lookup table points to the stored strings
+        StringInterner(const StringInterner &other) = delete;
+        StringInterner &operator=(const StringInterner &other) = delete;
+
+        /// Return the ID of the string, storing it if it was not interned yet.
+        NameID intern(std::string_view string);
+
+        /// Return the ID of the string, or NO_NAME if it was never interned.
+        [[nodiscard]] NameID find(std::string_view string) const;
+
+        /// Return the string of the given ID.
+        [[nodiscard]] std::string_view get(NameID id) const;
+
+        /// Amount of interned strings.
+        [[nodiscard]] size_t size() const;
+
+    private:
+        // A deque does not move its elements when growing, so the views in ids stay valid
+        std::deque<std::string> strings;
+        std::unordered_map<std::string_view, NameID> ids;
+    };
+} // namespace wrld
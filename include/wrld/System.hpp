@@ -8,17 +8,72 @@
 
 namespace wrld {
 
+    /// Components a System reads and writes, used by the Scheduler to run
+    /// systems that do not conflict at the same time.
+    struct SystemAccess {
+        ComponentSignature reads;
+        ComponentSignature writes;
+
+        /// The system did not declare its accesses: it is assumed to access everything.
+        bool exclusive = true;
+
+        /// The system must run on the main thread (for example because it uses OpenGL).
+        bool main_thread = false;
+
+        /// Returns true if the two systems cannot run at the same time.
+        [[nodiscard]] bool conflicts_with(const SystemAccess &other) const;
+    };
+
+    /// Logic executed on each frame, usually by the Scheduler.
+    /// Systems run by the Scheduler may run in parallel with other systems: they must declare the
+    /// components they access (see reads and writes), and make structural changes
+    /// (creating/deleting entities, attaching/detaching components) through World::commands.
     class System {
     public:
         explicit System(World &world);
 
         virtual ~System() = default;
 
-        /// Called by the event-loop on each frame.
+        /// Called by the event-loop on each frame. Executes the system, then starts a new
+        /// World tick so that the next run only sees changes made after this one.
+        void run();
+
+        /// Implementation of the system.
         virtual void exec() = 0;
 
+        [[nodiscard]] const SystemAccess &get_access() const;
+
     protected:
         World &world;
+
+        /// Tick at which the system last ran. 0 if it never ran.
+        Tick last_run_tick = 0;
+
+        /// Declare that the system reads components of the given types.
+        template<ComponentConcept... Cs>
+        void reads() {
+            (access.reads.set(component_type_id<Cs>()), ...);
+            access.exclusive = false;
+        }
+
+        /// Declare that the system modifies components of the given types.
+        template<ComponentConcept... Cs>
+        void writes() {
+            (access.writes.set(component_type_id<Cs>()), ...);
+            access.exclusive = false;
+        }
+
+        /// Force the system to run on the main thread.
+        void pin_to_main_thread();
+
+        /// Return a View whose Added and Changed filters match changes made since the last run.
+        template<typename... Cs>
+        View<Cs...> query() {
+            return world.view<Cs...>(last_run_tick);
+        }
+
+    private:
+        SystemAccess access;
     };
 
 } // namespace wrld
@@ -0,0 +1,79 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wrld {
+    /// Fixed set of worker threads executing submitted tasks, with work stealing:
+    /// each worker has its own queue, and takes tasks from the others when it is empty.
+    /// Workers are started on construction and joined on destruction,
+    /// after every pending task was executed.
+    class ThreadPool {
+    public:
+        /// Start thread_count workers. 0 means one less than the amount of hardware threads
+        /// (the thread owning the pool is expected to work too), with a minimum of 1.
+        explicit ThreadPool(size_t thread_count = 0);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &other) = delete;
+        ThreadPool &operator=(const ThreadPool &other) = delete;
+
+        /// Queue a task to be executed by a worker. The task must not throw.
+        /// Tasks submitted by a worker go to its own queue, the others are spread over the workers.
+        void submit(std::function<void()> task);
+
+        /// Execute one pending task on the calling thread, if any. Returns false if there was none.
+        /// Used to help the workers instead of blocking while waiting for tasks.
+        bool run_pending_task();
+
+        /// Call f(begin, end) for each chunk of [0, count), in parallel, and wait for all of them.
+        /// The chunks only depend on count and chunk_size, not on the amount of threads.
+        /// The calling thread runs chunks too, and only waits for the chunks already started by the workers once
+        /// none is left, so this can be used from inside a task. It never runs unrelated tasks while waiting.
+        /// If f throws, the other chunks still run and the first exception is rethrown.
+        template<typename F>
+        void parallel_for(size_t count, size_t chunk_size, F &&f);
+
+        /// Amount of worker threads.
+        [[nodiscard]] size_t get_thread_count() const;
+
+    private:
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+        // Amount of queued tasks, over every queue
+        std::atomic<size_t> queued = 0;
+        // Queue receiving the next task submitted from outside the pool
+        std::atomic<size_t> next_queue = 0;
+
+        // Idle workers sleep on this condition
+        std::mutex sleep_mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+
+        /// Take a task, from the given queue first (the back, most recent), then from the
+        /// others (the front, oldest). Returns an empty function if no task was found.
+        std::function<void()> take_task(size_t first_queue);
+
+        void work(size_t index);
+    };
+} // namespace wrld
+
+#include <wrld/ThreadPool.tpp>
@@ -0,0 +1,71 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/ThreadPool.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <type_traits>
+
+namespace wrld {
+    template<typename F>
+    void ThreadPool::parallel_for(const size_t count, size_t chunk_size, F &&f) {
+        if (count == 0)
+            return;
+        chunk_size = std::max<size_t>(chunk_size, 1);
+
+        // Shared with the runners, which may start after this call returned: they then find no chunk left,
+        // and never use f
+        struct State {
+            size_t count;
+            size_t chunk_size;
+            size_t chunk_count;
+            std::remove_reference_t<F> *f;
+            std::atomic<size_t> next_chunk = 0;
+            std::atomic<size_t> remaining;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+        };
+
+        const auto state = std::make_shared<State>();
+        state->count = count;
+        state->chunk_size = chunk_size;
+        state->chunk_count = (count + chunk_size - 1) / chunk_size;
+        state->f = &f;
+        state->remaining = state->chunk_count;
+
+        // Claim and run chunks until none is left
+        const auto run_chunks = [](State &state) {
+            size_t chunk;
+            while ((chunk = state.next_chunk.fetch_add(1, std::memory_order_relaxed)) < state.chunk_count) {
+                try {
+                    const size_t begin = chunk * state.chunk_size;
+                    (*state.f)(begin, std::min(begin + state.chunk_size, state.count));
+                } catch (...) {
+                    const std::lock_guard lock(state.error_mutex);
+                    if (!state.error)
+                        state.error = std::current_exception();
+                }
+                state.remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        };
+
+        // One runner per worker at most, the calling thread being one of them
+        const size_t runner_count = std::min(state->chunk_count, get_thread_count() + 1);
+        for (size_t i = 1; i < runner_count; i++)
+            submit([state, run_chunks] { run_chunks(*state); });
+        run_chunks(*state);
+
+        // Only wait for the chunks of this loop: running other tasks here (like a whole system) would delay
+        // the caller for an unbounded time
+        while (state->remaining.load(std::memory_order_acquire) > 0)
+            std::this_thread::yield();
+
+        if (state->error)
+            std::rethrow_exception(state->error);
+    }
+} // namespace wrld
@@ -0,0 +1,81 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#pragma once
+
+#include <wrld/concepts.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+namespace wrld {
+    /// Dense integer identifying a type inside a family (components, resources).
+    typedef size_t TypeId;
+
+    static constexpr TypeId INVALID_TYPE_ID = std::numeric_limits<TypeId>::max();
+
+    /// Assigns dense TypeIds to types, the first time each type is queried.
+    /// Each Family has its own counter so IDs start at 0 and can be used as array indices.
+    /// Unlike std::type_index, getting the ID of a type costs no RTTI lookup nor hashing.
+    template<typename Family>
+    class TypeIdFamily {
+    public:
+        template<typename T>
+        static TypeId get() {
+            static const TypeId id = counter.fetch_add(1);
+            return id;
+        }
+
+        /// Amount of IDs given so far.
+        static TypeId count() { return counter.load(); }
+
+    private:
+        static inline std::atomic<TypeId> counter = 0;
+    };
+
+    template<ComponentConcept C>
+    TypeId component_type_id() {
+        return TypeIdFamily<Component>::get<C>();
+    }
+
+    /// Tags share the TypeIds of components, as both are bits of the entity signatures.
+    template<TagConcept T>
+    TypeId tag_type_id() {
+        return TypeIdFamily<Component>::get<T>();
+    }
+
+    /// TypeId of a component or a tag, i.e. its bit in the entity signatures.
+    template<typename T>
+        requires ComponentConcept<T> || TagConcept<T>
+    TypeId signature_type_id() {
+        return TypeIdFamily<Component>::get<T>();
+    }
+
+    template<ResourceConcept R>
+    TypeId resource_type_id() {
+        return TypeIdFamily<Resource>::get<R>();
+    }
+
+    /// Tells the base class constructors (Component, Resource) the TypeId of the object
+    /// being built on this thread, as the concrete type is only known by the code creating it.
+    template<typename Family>
+    class TypeConstructionScope {
+    public:
+        explicit TypeConstructionScope(const TypeId type_id) : previous(current) { current = type_id; }
+
+        ~TypeConstructionScope() { current = previous; }
+
+        TypeConstructionScope(const TypeConstructionScope &other) = delete;
+        TypeConstructionScope &operator=(const TypeConstructionScope &other) = delete;
+
+        /// TypeId of the object being constructed, or INVALID_TYPE_ID.
+        static TypeId get_current() { return current; }
+
+    private:
+        TypeId previous;
+
+        static inline thread_local TypeId current = INVALID_TYPE_ID;
+    };
+} // namespace wrld
@@ -0,0 +1,179 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#pragma once
+
+#include <wrld/ComponentStorage.hpp>
+#include <wrld/ThreadPool.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace wrld {
+    /// Marks a component of a View as optional: entities without it are still
+    /// yielded, with a nullptr instead of a reference.
+    template<ComponentConcept C>
+    struct Optional {};
+
+    /// Marks a component of a View as required, and only matches entities
+    /// whose component was added after the tick given to the View.
+    template<ComponentConcept C>
+    struct Added {};
+
+    /// Marks a component of a View as required, and only matches entities
+    /// whose component was added or changed after the tick given to the View.
+    template<ComponentConcept C>
+    struct Changed {};
+
+    enum ViewFilter { NO_FILTER, ADDED_FILTER, CHANGED_FILTER };
+
+    template<typename T>
+    struct ViewTraits {
+        static_assert(ComponentConcept<T>, "View parameters must be components, Optional, Added or Changed");
+
+        typedef T Component;
+        typedef T &Reference;
+        static constexpr bool OPTIONAL = false;
+        static constexpr ViewFilter FILTER = NO_FILTER;
+    };
+
+    template<ComponentConcept T>
+    struct ViewTraits<Optional<T>> {
+        typedef T Component;
+        typedef T *Reference;
+        static constexpr bool OPTIONAL = true;
+        static constexpr ViewFilter FILTER = NO_FILTER;
+    };
+
+    template<ComponentConcept T>
+    struct ViewTraits<Added<T>> {
+        typedef T Component;
+        typedef T &Reference;
+        static constexpr bool OPTIONAL = false;
+        static constexpr ViewFilter FILTER = ADDED_FILTER;
+    };
+
+    template<ComponentConcept T>
+    struct ViewTraits<Changed<T>> {
+        typedef T Component;
+        typedef T &Reference;
+        static constexpr bool OPTIONAL = false;
+        static constexpr ViewFilter FILTER = CHANGED_FILTER;
+    };
+
+    /// Non-owning query over every entity having all the required components.
+    /// Iteration walks the dense array of the smallest required storage and checks the
+    /// others at once with the component signature of the entity. Nothing is allocated: a View is a handful of pointers and can be
+    /// created each frame.
+    ///
+    /// The View is invalidated by any structural change to the iterated storages
+    /// (attaching/detaching components, deleting entities).
+    template<typename... Cs>
+    class View {
+        static_assert(sizeof...(Cs) > 0, "A View needs at least one component");
+        static_assert((!ViewTraits<Cs>::OPTIONAL || ...), "A View needs at least one non-optional component");
+
+    public:
+        typedef std::tuple<ComponentStorage<typename ViewTraits<Cs>::Component> *...> Storages;
+        typedef std::tuple<EntityID, typename ViewTraits<Cs>::Reference...> Item;
+
+        class Iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::ptrdiff_t difference_type;
+            typedef Item value_type;
+            typedef Item reference;
+
+            Iterator() = default;
+
+            Iterator(const View *view, size_t position);
+
+            Item operator*() const;
+
+            Iterator &operator++();
+
+            Iterator operator++(int);
+
+            bool operator==(const Iterator &other) const;
+
+        private:
+            const View *view = nullptr;
+            size_t position = 0;
+
+            /// Move forward until the current entity matches the View, or the end is reached.
+            void skip_unmatched();
+        };
+
+        /// Amount of entities per task of par_each, if not specified.
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 1024;
+
+        /// signatures are the component signatures of the World entities, indexed by entity index.
+        /// thread_pool is used by par_each. since is the tick used by Added and Changed filters.
+        View(Storages storages, const std::vector<ComponentSignature> &signatures, ThreadPool &thread_pool,
+             Tick since = 0);
+
+        [[nodiscard]] Iterator begin() const;
+
+        [[nodiscard]] Iterator end() const;
+
+        /// Call f(EntityID, components...) for each matching entity.
+        template<typename F>
+        void each(F &&f) const;
+
+        /// Call f(EntityID, components...) for each matching entity, in parallel.
+        /// The iterated storage is split in chunks of chunk_size entities, distributed over the thread pool.
+        /// The chunks only depend on the storage and chunk_size, so a run can be reproduced.
+        /// f must be safe to call concurrently on different entities. Structural changes must go
+        /// through World::commands.
+        template<typename F>
+        void par_each(F &&f, size_t chunk_size = DEFAULT_CHUNK_SIZE) const;
+
+        /// Return a copy of this View only matching entities having all the given tags or components.
+        /// They are checked with the entity signature, and not yielded.
+        /// Usage: world.view<cpt::Transform>().with<tag::Selected>()
+        template<typename... Ts>
+        [[nodiscard]] View with() const;
+
+        /// Return a copy of this View skipping entities having any of the given tags or components.
+        /// Usage: world.view<cpt::StaticModel>().without<tag::Hidden>()
+        template<typename... Ts>
+        [[nodiscard]] View without() const;
+
+        /// Upper bound of the amount of entities yielded (size of the iterated storage).
+        [[nodiscard]] size_t size_hint() const;
+
+        /// Returns true if the View yields no entity.
+        [[nodiscard]] bool empty() const;
+
+    private:
+        Storages storages;
+        const std::vector<ComponentSignature> &signatures;
+        ThreadPool &thread_pool;
+        Tick since;
+
+        // Component types (and tags) every matched entity has
+        ComponentSignature required;
+        // Component types and tags no matched entity has
+        ComponentSignature excluded;
+
+        // Entities of the smallest required storage. nullptr if a required storage does not exist.
+        const std::vector<EntityID> *pivot = nullptr;
+        const ComponentStorageBase *pivot_storage = nullptr;
+
+        // The pivot storage is the only requirement: the signatures do not need to be checked
+        bool pivot_only = false;
+
+        /// Returns true if the entity at the given position of the pivot matches the View.
+        [[nodiscard]] bool matches(size_t position) const;
+
+        /// Components of the entity at the given position of the pivot.
+        /// Components of the pivot storage are read at that position, without lookup.
+        [[nodiscard]] Item get(size_t position) const;
+    };
+} // namespace wrld
+
+#include <wrld/View.tpp>
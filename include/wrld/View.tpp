@@ -0,0 +1,189 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#pragma once
+
+#include <wrld/View.hpp>
+
+#include <utility>
+
+namespace wrld {
+    template<typename... Cs>
+    View<Cs...>::Iterator::Iterator(const View *view, const size_t position) : view(view), position(position) {
+        skip_unmatched();
+    }
+
+    template<typename... Cs>
+    typename View<Cs...>::Item View<Cs...>::Iterator::operator*() const {
+        return view->get(position);
+    }
+
+    template<typename... Cs>
+    typename View<Cs...>::Iterator &View<Cs...>::Iterator::operator++() {
+        position += 1;
+        skip_unmatched();
+        return *this;
+    }
+
+    template<typename... Cs>
+    typename View<Cs...>::Iterator View<Cs...>::Iterator::operator++(int) {
+        Iterator res = *this;
+        ++*this;
+        return res;
+    }
+
+    template<typename... Cs>
+    bool View<Cs...>::Iterator::operator==(const Iterator &other) const {
+        return position == other.position;
+    }
+
+    template<typename... Cs>
+    void View<Cs...>::Iterator::skip_unmatched() {
+        if (view == nullptr || view->pivot == nullptr)
+            return;
+
+        const size_t size = view->pivot->size();
+        while (position < size && !view->matches(position))
+            position += 1;
+    }
+
+    template<typename... Cs>
+    View<Cs...>::View(Storages storages, const std::vector<ComponentSignature> &signatures, ThreadPool &thread_pool,
+                      const Tick since) :
+        storages(std::move(storages)), signatures(signatures), thread_pool(thread_pool), since(since) {
+        // Pick the smallest required storage as the one to iterate.
+        // If a required storage does not exist, nothing can match.
+        bool missing = false;
+        size_t smallest = 0;
+
+        const auto consider = [&]<typename C>(const ComponentStorage<typename ViewTraits<C>::Component> *storage) {
+            if constexpr (!ViewTraits<C>::OPTIONAL) {
+                required.set(component_type_id<typename ViewTraits<C>::Component>());
+                if (storage == nullptr) {
+                    missing = true;
+                } else if (pivot == nullptr || storage->size() < smallest) {
+                    pivot = &storage->get_entities();
+                    pivot_storage = storage;
+                    smallest = storage->size();
+                }
+            }
+        };
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (consider.template operator()<Cs>(std::get<I>(this->storages)), ...);
+        }(std::index_sequence_for<Cs...>{});
+
+        if (missing)
+            pivot = nullptr;
+        pivot_only = required.count() == 1;
+    }
+
+    template<typename... Cs>
+    typename View<Cs...>::Iterator View<Cs...>::begin() const {
+        return Iterator(this, 0);
+    }
+
+    template<typename... Cs>
+    typename View<Cs...>::Iterator View<Cs...>::end() const {
+        return Iterator(this, pivot == nullptr ? 0 : pivot->size());
+    }
+
+    template<typename... Cs>
+    template<typename F>
+    void View<Cs...>::each(F &&f) const {
+        if (pivot == nullptr)
+            return;
+
+        for (size_t position = 0; position < pivot->size(); position++) {
+            if (matches(position))
+                std::apply(f, get(position));
+        }
+    }
+
+    template<typename... Cs>
+    template<typename F>
+    void View<Cs...>::par_each(F &&f, const size_t chunk_size) const {
+        if (pivot == nullptr)
+            return;
+
+        thread_pool.parallel_for(pivot->size(), chunk_size, [&](const size_t begin, const size_t end) {
+            for (size_t position = begin; position < end; position++) {
+                if (matches(position))
+                    std::apply(f, get(position));
+            }
+        });
+    }
+
+    template<typename... Cs>
+    template<typename... Ts>
+    View<Cs...> View<Cs...>::with() const {
+        View res = *this;
+        (res.required.set(signature_type_id<Ts>()), ...);
+        res.pivot_only = false;
+        return res;
+    }
+
+    template<typename... Cs>
+    template<typename... Ts>
+    View<Cs...> View<Cs...>::without() const {
+        View res = *this;
+        (res.excluded.set(signature_type_id<Ts>()), ...);
+        res.pivot_only = false;
+        return res;
+    }
+
+    template<typename... Cs>
+    size_t View<Cs...>::size_hint() const {
+        return pivot == nullptr ? 0 : pivot->size();
+    }
+
+    template<typename... Cs>
+    bool View<Cs...>::empty() const {
+        return begin() == end();
+    }
+
+    template<typename... Cs>
+    bool View<Cs...>::matches(const size_t position) const {
+        const EntityID id = (*pivot)[position];
+        if (!pivot_only) {
+            const ComponentSignature &signature = signatures[entity_index(id)];
+            if ((signature & required) != required || (signature & excluded).any())
+                return false;
+        }
+
+        // Only Added and Changed filters need to look at the storages
+        const auto match = [this, id]<typename C>(const ComponentStorage<typename ViewTraits<C>::Component> *storage) {
+            if constexpr (ViewTraits<C>::FILTER == ADDED_FILTER)
+                return storage->added_since(id, since);
+            else if constexpr (ViewTraits<C>::FILTER == CHANGED_FILTER)
+                return storage->changed_since(id, since);
+            else
+                return true;
+        };
+
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return (match.template operator()<Cs>(std::get<I>(storages)) && ...);
+        }(std::index_sequence_for<Cs...>{});
+    }
+
+    template<typename... Cs>
+    typename View<Cs...>::Item View<Cs...>::get(const size_t position) const {
+        const EntityID id = (*pivot)[position];
+        const auto fetch = [this, id, position]<typename C>(ComponentStorage<typename ViewTraits<C>::Component> *storage)
+                -> typename ViewTraits<C>::Reference {
+            if constexpr (ViewTraits<C>::OPTIONAL) {
+                if (storage == nullptr)
+                    return nullptr;
+                return storage->find(id);
+            } else {
+                if (storage == pivot_storage)
+                    return *storage->get_components()[position];
+                return *storage->find(id);
+            }
+        };
+
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return Item(id, fetch.template operator()<Cs>(std::get<I>(storages))...);
+        }(std::index_sequence_for<Cs...>{});
+    }
+} // namespace wrld
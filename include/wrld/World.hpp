@@ -4,184 +4,654 @@
 
 #pragma once
 
+#include <wrld/ComponentRef.hpp>
+#include <wrld/ComponentStorage.hpp>
+#include <wrld/Entity.hpp>
+#include <wrld/Query.hpp>
+#include <wrld/StringInterner.hpp>
+#include <wrld/View.hpp>
 #include <wrld/components/Component.hpp>
 #include <wrld/resources/Resource.hpp>
 #include <wrld/resources/Rc.hpp>
+#include <wrld/resources/ResourceRegistry.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <format>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <stdexcept>
+#include <string_view>
 #include <typeindex>
 #include <typeinfo>
 #include <unordered_map>
 #include <vector>
 
 namespace wrld {
-    typedef size_t EntityID;
-    typedef std::unordered_map<std::type_index, std::unordered_map<std::string, Rc<Resource>>> ResourcePool;
-    typedef std::unordered_map<std::type_index, Rc<Resource>> DefaultResourcePool;
-    typedef std::unordered_map<std::type_index, std::unordered_map<EntityID, std::shared_ptr<Component>>> ComponentPool;
+
+    /// Identifies an observer registered with World::on_add, on_remove or on_change.
+    typedef size_t ObserverID;
+
+    class CommandBuffer;
+    class FileWatcher;
+    class ResourceLoader;
+    class Scheduler;
+    class ThreadPool;
 
     class World {
     public:
         World();
+        ~World();
+
+        // Components and resources keep a reference to their World
+        World(const World &other) = delete;
+        World(World &&other) = delete;
+        World &operator=(const World &other) = delete;
+        World &operator=(World &&other) = delete;
 
         /// Creates an Entity, returning its ID. An optional name can be given. It doesn't need to be unique.
+        /// The slot of a deleted entity may be reused, but never with the same ID.
         EntityID create_entity(const std::string &name = "");
 
-        std::string get_entity_name(EntityID id);
+        /// Creates count Entities at once, all with the given name (if any).
+        /// The returned IDs are valid until the next creation or deletion of an entity.
+        std::span<const EntityID> create_entities(size_t count, const std::string &name = "");
+
+        /// Creates count Entities, each having a component of every given type.
+        /// One tuple of constructor arguments is given per component type, shared by every entity:
+        /// world.spawn_batch<cpt::Transform, cpt::StaticModel>(n, std::tuple{position}, std::tuple{model})
+        /// The returned IDs are valid until the next creation or deletion of an entity.
+        template<ComponentConcept... Cs, typename... ArgTuples>
+        std::span<const EntityID> spawn_batch(const size_t count, const ArgTuples &...args) {
+            static_assert(sizeof...(Cs) == sizeof...(ArgTuples), "One tuple of arguments is required per component");
+
+            const std::span<const EntityID> ids = create_entities(count);
+            (attach_components_from<Cs>(ids, [&args](size_t) -> const ArgTuples & { return args; }), ...);
+            return ids;
+        }
+
+        /// Return the name given to the entity at creation, or an empty string if it has none.
+        /// Names are interned: the view stays valid as long as the World.
+        [[nodiscard]] std::string_view get_name(EntityID id) const;
+
+        /// Return the name of the entity, or "#index" if it was created without one. For display.
+        [[nodiscard]] std::string get_entity_name(EntityID id) const;
+
+        /// Return an alive entity with the given name, or NULL_ENTITY if there is none.
+        /// Names are indexed: this does not scan the entities.
+        [[nodiscard]] EntityID find_entity_by_name(std::string_view name) const;
+
+        /// Return every alive entity with the given name, in no particular order.
+        /// The span is valid until the next creation or deletion of an entity.
+        [[nodiscard]] std::span<const EntityID> find_entities_by_name(std::string_view name) const;
 
         /// Delete the Entity and all attached Components.
+        /// Every copy of its ID becomes stale: entity_exists returns false for them.
         void delete_entity(EntityID id);
 
-        std::unordered_map<EntityID, std::string> get_entities() const;
+        /// Return every alive entity, in no particular order. Nothing is copied:
+        /// the span is valid until the next creation or deletion of an entity.
+        [[nodiscard]] std::span<const EntityID> get_entities() const;
+
+        /// Returns true if the given entity id exists in this world.
+        /// Returns false for IDs of deleted entities, even if their slot was reused.
+        [[nodiscard]] bool entity_exists(EntityID id) const;
 
         /// Attach a new component of the given type to the entity,
-        /// returning a reference to it.
+        /// returning a handle to it.
         template<ComponentConcept C, typename... Args>
-        std::shared_ptr<C> attach_component(const EntityID id, Args &&...args) {
+        ComponentRef<C> attach_component(const EntityID id, Args &&...args) {
             if (!entity_exists(id))
                 throw std::runtime_error("Creating a Component on inexisting Entity");
 
-            if (!components.contains(std::type_index(typeid(C)))) {
-                components[std::type_index(typeid(C))] = {};
-            }
+            ComponentStorage<C> &storage = get_or_create_storage<C>();
 
-            if (components[std::type_index(typeid(C))].contains(id))
+            const TypeId type_id = component_type_id<C>();
+            if (entity_signatures[entity_index(id)].test(type_id))
                 throw std::runtime_error("The entity already has a component of this type.");
 
             // Returns the created component
-            auto new_comp = std::make_shared<C>(id, *this, std::forward<Args>(args)...);
-            components[std::type_index(typeid(C))][id] = new_comp;
-            return new_comp;
+            C &res = storage.emplace(id, *this, std::forward<Args>(args)...);
+            entity_signatures[entity_index(id)].set(type_id);
+            update_queries(id, type_id);
+            notify(ADD_EVENT, type_id, id, res);
+            return ComponentRef<C>(&res);
+        }
+
+        /// Attach a new component of the given type to each of the (distinct) entities,
+        /// constructing them with the same arguments. The components are stored in consecutive slots.
+        template<ComponentConcept C, typename... Args>
+        void attach_components(const std::span<const EntityID> ids, const Args &...args) {
+            attach_components_from<C>(ids, [&args...](size_t) { return std::forward_as_tuple(args...); });
+        }
+
+        /// Attach a new component of the given type to each of the (distinct) entities.
+        /// make_args(i) returns the tuple of constructor arguments of the component of ids[i].
+        template<ComponentConcept C, typename MakeArgs>
+        void attach_components_from(const std::span<const EntityID> ids, MakeArgs &&make_args) {
+            ComponentStorage<C> &storage = get_or_create_storage<C>();
+            const TypeId type_id = component_type_id<C>();
+
+            // Check everything before constructing anything
+            for (const EntityID id: ids) {
+                if (!entity_exists(id))
+                    throw std::runtime_error("Creating a Component on inexisting Entity");
+                if (entity_signatures[entity_index(id)].test(type_id))
+                    throw std::runtime_error("The entity already has a component of this type.");
+            }
+
+            storage.emplace_batch(ids, *this, std::forward<MakeArgs>(make_args));
+            for (const EntityID id: ids) {
+                entity_signatures[entity_index(id)].set(type_id);
+                update_queries(id, type_id);
+            }
+
+            if (has_observers(ADD_EVENT, type_id)) {
+                for (const EntityID id: ids)
+                    notify(ADD_EVENT, type_id, id, *storage.find(id));
+            }
+        }
+
+        /// Detach the component of the given type from the entity, destroying it.
+        /// Does nothing if the entity has no such component.
+        template<ComponentConcept C>
+        void detach_component(const EntityID id) {
+            const TypeId type_id = component_type_id<C>();
+            if (!has_component_type(id, type_id))
+                return;
+
+            notify(REMOVE_EVENT, type_id, id, *components[type_id]->find_component(id));
+            entity_signatures[entity_index(id)].reset(type_id);
+            update_queries(id, type_id);
+            components[type_id]->remove(id);
         }
 
-        /// Returns an optional pointer to the component of the given type
+        /// Returns true if the entity has a component of each of the given types.
+        template<ComponentConcept... Cs>
+        [[nodiscard]] bool has_components(const EntityID id) const {
+            return (has_component_type(id, component_type_id<Cs>()) && ...);
+        }
+
+        /// Add the tag T to the entity. Tags are empty types marking entities ("static", "selected"...):
+        /// they are not stored anywhere but in the entity signature, and filter Views with View::with and
+        /// View::without. Does nothing if the entity already has the tag.
+        template<TagConcept T>
+        void add_tag(const EntityID id) {
+            if (!entity_exists(id))
+                throw std::runtime_error("Adding a tag to inexisting Entity");
+
+            set_tag(id, tag_type_id<T>(), true);
+        }
+
+        /// Remove the tag T from the entity. Does nothing if the entity does not have it.
+        template<TagConcept T>
+        void remove_tag(const EntityID id) {
+            if (!entity_exists(id))
+                return;
+
+            set_tag(id, tag_type_id<T>(), false);
+        }
+
+        /// Returns true if the entity has the tag T.
+        template<TagConcept T>
+        [[nodiscard]] bool has_tag(const EntityID id) const {
+            return has_component_type(id, tag_type_id<T>());
+        }
+
+        /// Returns true if the tag T was added to or removed from an entity after the given tick.
+        template<TagConcept T>
+        [[nodiscard]] bool tag_changed_since(const Tick since) const {
+            const TypeId type_id = tag_type_id<T>();
+            return type_id < tag_changes.size() && tag_changes[type_id] > since;
+        }
+
+        /// Return the set of component types attached to the entity, indexed by TypeId.
+        /// Empty if the entity does not exist.
+        [[nodiscard]] ComponentSignature get_signature(EntityID id) const;
+
+        /// Returns an optional handle to the component of the given type
         /// attached to the given object.
         template<ComponentConcept C>
-        std::optional<std::shared_ptr<C>> get_component_opt(const EntityID id) {
-            if (!components.contains(std::type_index(typeid(C))))
+        std::optional<ComponentRef<C>> get_component_opt(const EntityID id) {
+            ComponentStorage<C> *storage = get_storage<C>();
+            if (storage == nullptr)
                 return std::nullopt;
-            if (!components[std::type_index(typeid(C))].contains(id))
+
+            C *cpt = storage->find(id);
+            if (cpt == nullptr)
                 return std::nullopt;
 
-            return static_pointer_cast<C>(components[std::type_index(typeid(C))][id]);
+            return ComponentRef<C>(cpt);
         }
 
-        /// Returns a pointer to the component of the given type attached to the
+        /// Returns a handle to the component of the given type attached to the
         /// given object. Throws std::runtime_error if no component of this type
         /// is attached to the object.
         template<ComponentConcept C>
-        std::shared_ptr<C> get_component(const EntityID id) {
-            if (!components.contains(std::type_index(typeid(C))))
-                throw std::runtime_error(
-                        std::format("Entity {} does not have a component {} attached to it", id, typeid(C).name()));
-            if (!components[std::type_index(typeid(C))].contains(id))
+        ComponentRef<C> get_component(const EntityID id) {
+            ComponentStorage<C> *storage = get_storage<C>();
+            C *cpt = storage == nullptr ? nullptr : storage->find(id);
+
+            if (cpt == nullptr)
                 throw std::runtime_error(
                         std::format("Entity {} does not have a component {} attached to it", id, typeid(C).name()));
 
-            return static_pointer_cast<C>(components[std::type_index(typeid(C))][id]);
+            return ComponentRef<C>(cpt);
+        }
+
+        /// Return a View over every entity having all the given components.
+        /// Components wrapped in Optional<C> do not filter entities and are yielded as pointers.
+        /// Components wrapped in Added<C> or Changed<C> only match if they were added (or changed)
+        /// after the since tick.
+        /// Usage: for (const auto &[entity, transform, model]: world.view<cpt::Transform, cpt::StaticModel>())
+        template<typename... Cs>
+        View<Cs...> view(const Tick since = 0) {
+            return View<Cs...>(std::make_tuple(get_storage<typename ViewTraits<Cs>::Component>()...), entity_signatures,
+                               *thread_pool, since);
+        }
+
+        /// Return the cached Query over every entity having all the given components (see Query).
+        /// The Query is created on the first call, then kept up to date by structural changes:
+        /// later calls only return it, so systems can call this every frame or keep the reference.
+        /// Creating a Query is not thread-safe: do it from the main thread, for example in a system constructor.
+        /// Usage: for (const auto &[entity, transform, model]: world.query<cpt::Transform, cpt::StaticModel>())
+        template<typename... Cs>
+        Query<Cs...> &query() {
+            const TypeId query_id = TypeIdFamily<QueryBase>::get<Query<Cs...>>();
+            if (query_id < queries.size() && queries[query_id])
+                return static_cast<Query<Cs...> &>(*queries[query_id]);
+
+            if (query_id >= queries.size())
+                queries.resize(query_id + 1);
+            queries[query_id] = std::make_unique<Query<Cs...>>(components, *thread_pool);
+            register_query(*queries[query_id]);
+            return static_cast<Query<Cs...> &>(*queries[query_id]);
+        }
+
+        /// Current tick. Components added or changed now are stamped with it.
+        [[nodiscard]] Tick get_tick() const;
+
+        /// Start a new tick, returning the one that just ended.
+        Tick advance_tick();
+
+        /// Record that the component of the given type attached to the entity was modified.
+        /// Components call this from their setters.
+        template<ComponentConcept C>
+        void mark_changed(const EntityID id) {
+            mark_changed(component_type_id<C>(), id);
+        }
+
+        /// Record that the component of the given TypeId attached to the entity was modified.
+        void mark_changed(TypeId type_id, EntityID id);
+
+        /// Returns true if a component of the given type was added, changed or removed after the given tick.
+        template<ComponentConcept C>
+        [[nodiscard]] bool component_changed_since(const Tick since) {
+            const ComponentStorage<C> *storage = get_storage<C>();
+            return storage != nullptr && storage->get_last_change() > since;
+        }
+
+        /// Returns true if the component of the given type attached to the entity was added or changed
+        /// after the given tick. False if the entity has no such component.
+        template<ComponentConcept C>
+        [[nodiscard]] bool component_changed_since(const EntityID id, const Tick since) {
+            const ComponentStorage<C> *storage = get_storage<C>();
+            return storage != nullptr && storage->changed_since(id, since);
+        }
+
+        /// Call f(entity, component) each time a component of type C is attached,
+        /// once it is constructed. Returns an ID to give to remove_observer.
+        /// Observers let systems maintain caches incrementally instead of scanning every entity each frame.
+        /// They must not register or remove observers.
+        template<ComponentConcept C, typename F>
+        ObserverID on_add(F &&f) {
+            return add_observer<C>(ADD_EVENT, std::forward<F>(f));
+        }
+
+        /// Call f(entity, component) each time a component of type C is about to be destroyed:
+        /// detached, or its entity deleted. Not called when the World itself is destroyed.
+        template<ComponentConcept C, typename F>
+        ObserverID on_remove(F &&f) {
+            return add_observer<C>(REMOVE_EVENT, std::forward<F>(f));
         }
 
+        /// Call f(entity, component) each time a component of type C is marked as changed (see mark_changed).
+        /// As systems may change components from several threads, these observers are called
+        /// under a lock, possibly from a worker thread.
+        template<ComponentConcept C, typename F>
+        ObserverID on_change(F &&f) {
+            return add_observer<C>(CHANGE_EVENT, std::forward<F>(f));
+        }
+
+        /// Unregister an observer. Does nothing if it was already removed.
+        void remove_observer(ObserverID id);
+
         /// Return a vector of entities that have the given type
         /// of component attached to them.
         template<ComponentConcept C>
         std::vector<EntityID> get_entities_with_component() {
-            std::vector<EntityID> res;
-            res.reserve(components[std::type_index(typeid(C))].size());
-
-            for (const auto k: components[std::type_index(typeid(C))] | std::views::keys) {
-                res.push_back(k);
-            }
+            const ComponentStorage<C> *storage = get_storage<C>();
+            if (storage == nullptr)
+                return {};
 
-            return res;
+            return storage->get_entities();
         }
 
         /// Return all components type attached to the entity.
-        // todo: maybe store thoses maps to accelerate this
         std::vector<std::type_index> get_components_of_entity(EntityID id) const;
 
+        // Resources and threads:
+        // - create_resource, get_resource, find_resource, get_default and destroy_resource may be called from any
+        //   thread, as well as copying and dropping an Rc (see ResourceRegistry), and attaching, detaching or
+        //   listing the users of a resource (Rc::get_users returns copies). Worker threads can build resources,
+        //   like the ResourceLoader does.
+        // - Resource constructors create no OpenGL object: GPU objects are created by the main thread, when the
+        //   resource is uploaded or first used.
+        // - OpenGL functions, get_resources and collect_unused_resources must only be called from the main thread,
+        //   and so must the release of the last Rc to a resource holding GPU objects.
+
+        /// Create a resource with the given name. If a resource of the same type already has this name,
+        /// the resource is named "{name}:{n}" instead, n increasing with each resource created with this name.
         template<ResourceConcept R>
         Rc<R> create_resource(const std::string &name) {
-            if (!resources.contains(std::type_index(typeid(R)))) {
-                resources[std::type_index(typeid(R))] = {};
-            }
-
-            // Create unique name from given name
-            std::string new_name = name;
-            while (resources.at(std::type_index(typeid(R))).contains(new_name)) {
-                new_name = std::format("{}:{}", name, generate_random_id());
-            }
-
-            // Returns the created resource
-            Rc<R> new_ressource = Rc<R>(new_name, *this);
-
-            if (!resources.contains(std::type_index(typeid(R)))) {
-                resources[std::type_index(typeid(R))] = {};
+            const TypeId type_id = resource_type_id<R>();
+            // Reserved before constructing R, so that two threads can not create resources with the same name
+            const NameID name_id = resource_registry->reserve_name(type_id, name);
+
+            Rc<R> new_ressource;
+            try {
+                new_ressource = make_resource<R>(std::string(resource_registry->get_name(name_id)), name_id);
+            } catch (...) {
+                resource_registry->release_name(type_id, name_id);
+                throw;
             }
 
-            resources.at(std::type_index(typeid(R))).insert_or_assign(new_name, new_ressource.template as<Resource>());
+            resource_registry->insert(type_id, name_id, new_ressource.template as<Resource>());
             return new_ressource;
         }
 
         /// Return the resource of the given type with the given name.
         /// Throws std::runtime_error if no such resource exists.
         template<ResourceConcept R>
-        Rc<R> get_resource(const std::string &name) {
-            if (!resources.contains(std::type_index(typeid(R))))
+        Rc<R> get_resource(const std::string_view name) {
+            const Rc<Resource> resource = resource_registry->find(resource_type_id<R>(), name);
+            if (resource.get() == nullptr)
                 throw std::runtime_error("This resource does not exists");
 
-            if (!resources.at(std::type_index(typeid(R))).contains(name))
+            return resource.template as<R>();
+        }
+
+        /// Return the handle of the resource of the given type with the given name,
+        /// or an empty handle (see ResourceHandle::NO_INDEX) if no such resource exists.
+        /// Unlike names, handles are resolved without hashing: look the name up once, then use get_resource.
+        template<ResourceConcept R>
+        [[nodiscard]] ResourceHandle find_resource(const std::string_view name) const {
+            const Rc<Resource> resource = resource_registry->find(resource_type_id<R>(), name);
+            return resource.get() == nullptr ? ResourceHandle() : resource.get_handle();
+        }
+
+        /// Return the resource of the given handle (see Rc::get_handle).
+        /// Throws std::runtime_error if the resource was destroyed since.
+        template<ResourceConcept R>
+        Rc<R> get_resource(const ResourceHandle handle) {
+            ResourceSlot *slot = get_resource_storage(resource_type_id<R>()).acquire(handle);
+            if (slot == nullptr)
                 throw std::runtime_error("This resource does not exists");
 
-            return resources.at(std::type_index(typeid(R)))[name].as<R>();
+            return Rc<R>::adopt(slot);
         }
 
         /// Destroy the resource. It may still live until every Rc<R> is destroyed.
         /// Invalidate the given rc.
         template<ResourceConcept R>
         void destroy_resource(Rc<R> &rc) {
-            const std::string name = rc->get_name();
+            resource_registry->remove(resource_type_id<R>(), rc.get_handle());
             rc.invalidate();
-            resources.at(std::type_index(typeid(R))).erase(name);
         }
 
+        /// Return the default resource of the type, creating it on first use.
+        /// Once created, it is returned without taking any lock.
         template<ResourceConcept R>
         Rc<R> get_default() {
-            if (!default_resources.contains(std::type_index(typeid(R)))) {
-                Rc<R> new_resource = Rc<R>("default", *this);
-                const Rc<Resource> casted = new_resource.template as<Resource>();
+            const TypeId type_id = resource_type_id<R>();
+            if (const Rc<Resource> resource = resource_registry->get_default(type_id); resource.get() != nullptr)
+                return resource.template as<R>();
 
-                default_resources.insert_or_assign(std::type_index(typeid(R)), casted);
-            }
-
-            return default_resources.at(std::type_index(typeid(R))).as<R>();
+            const auto create = [this] { return make_resource<R>("default", NO_NAME).template as<Resource>(); };
+            return resource_registry->get_or_create_default(type_id, create).template as<R>();
         }
 
-        const ResourcePool &get_resources() const;
+        /// Return a copy of the named resources of every type.
+        ResourcePool get_resources() const;
 
-    private:
-        friend class System;
+        /// Destroy the resources only referenced by their name in the World: no component, resource or Rc uses
+        /// them. Keep an Rc to a resource to keep it alive. Default resources are never destroyed.
+        /// The resources are scanned incrementally, resuming where the previous call stopped, until all of them
+        /// were scanned or the time budget is exceeded. Return the amount of destroyed resources.
+        size_t collect_unused_resources(std::chrono::microseconds budget);
+
+        /// Return the command buffer of this world, used to record structural changes
+        /// (entity creation/deletion, component attachment/detachment) while iterating.
+        CommandBuffer &commands();
+
+        /// Apply the changes recorded in the command buffer.
+        void flush_commands();
+
+        /// Return the worker threads of this world, shared by the scheduler and parallel iterations.
+        ThreadPool &get_thread_pool();
+
+        /// Return the loader decoding the resources of this world on its worker threads.
+        ResourceLoader &get_loader();
 
-        // Stores Entity names
-        unsigned max_entity_id = 0;
-        std::unordered_map<EntityID, std::string> entities;
+        /// Return the watcher reloading the resources of this world when their files change.
+        FileWatcher &get_file_watcher();
 
-        // Default resources, one for each type. They are immutable.
-        DefaultResourcePool default_resources;
+        /// Return the accounting of the GPU memory used by the resources of this world.
+        GpuMemory &get_gpu_memory();
 
-        // Access a resource by its name. World::create_resource ensure that this name is unique.
-        ResourcePool resources;
+        /// Return the scheduler running the systems of this world.
+        Scheduler &get_scheduler();
 
-        // Access a component first by type then by entity ID.
+    private:
+        friend class System;
+        friend class CommandBuffer;
+        friend class Snapshot;
+        friend class FileWatcher;
+
+        static constexpr uint32_t NO_POSITION = std::numeric_limits<uint32_t>::max();
+
+        enum ObserverEvent { ADD_EVENT, REMOVE_EVENT, CHANGE_EVENT, OBSERVER_EVENT_COUNT };
+
+        struct Observer {
+            ObserverID id;
+            std::function<void(EntityID, Component &)> callback;
+        };
+
+        // Stamped on component additions and changes. Starts at 1 so that tick 0 is before everything.
+        // Atomic as systems running in parallel advance it.
+        std::atomic<Tick> current_tick = 1;
+
+        // Entity table, indexed by entity index. Index 0 is reserved so that NULL_ENTITY is never alive.
+        // Current generation of each slot.
+        std::vector<EntityGeneration> entity_generations;
+        // Position of the entity in alive_entities, or NO_POSITION if the slot is free.
+        std::vector<uint32_t> entity_positions;
+        // Dense array of alive entities.
+        std::vector<EntityID> alive_entities;
+        // Free slots, reused before growing the table.
+        std::vector<EntityIndex> free_entities;
+        // Slots reserved by reserve_entity_deferred past the end of the tables, added by grow_reserved_entities.
+        EntityIndex reserved_entities = 0;
+
+        // Component types attached to each entity, and its tags.
+        std::vector<ComponentSignature> entity_signatures;
+
+        // Tick of the last addition or removal of each tag, indexed by TypeId.
+        std::vector<Tick> tag_changes;
+
+        struct EntityName {
+            NameID name = NO_NAME;
+            // Position of the entity in named_entities[name]
+            uint32_t position = 0;
+        };
+
+        // Names given to entities, each stored once.
+        StringInterner entity_name_strings;
+        // Name of each entity slot, indexed by entity index. NO_NAME for unnamed entities and free slots.
+        std::vector<EntityName> entity_names;
+        // Alive entities having each name, indexed by NameID.
+        std::vector<std::vector<EntityID>> named_entities;
+
+        // Declared before the resources, which untrack their GPU memory when destroyed.
+        std::unique_ptr<GpuMemory> gpu_memory;
+
+        // Every resource, with their names and the default resources. Declared before anything holding an Rc,
+        // so that the storages are destroyed last.
+        std::unique_ptr<ResourceRegistry> resource_registry;
+
+        // Next slot scanned by collect_unused_resources.
+        TypeId collected_type = 0;
+        size_t collected_slot = 0;
+
+        // Access a component storage by type, then the component by entity ID.
         // Ensure that two components of the same type cannot be applied to the same entity.
         ComponentPool components;
 
-        static size_t generate_random_id();
+        // Observers of each event, indexed by the TypeId of the observed component.
+        std::array<std::vector<std::vector<Observer>>, OBSERVER_EVENT_COUNT> observers;
+        ObserverID next_observer_id = 1;
+        // Serializes the change observers, called from the threads changing components.
+        // Recursive as an observer may change other components.
+        std::recursive_mutex change_observers_mutex;
 
-        /// Returns true if the given entity id exists in this world.
-        bool entity_exists(EntityID id) const;
+        // Cached queries, indexed by their TypeId in the QueryBase family.
+        std::vector<std::unique_ptr<QueryBase>> queries;
+        // Queries requiring each component type, indexed by TypeId: the ones to update when it is attached or detached.
+        std::vector<std::vector<QueryBase *>> component_queries;
+
+        // Structural changes waiting for the next flush_commands.
+        std::unique_ptr<CommandBuffer> command_buffer;
+
+        // Owns the threads decoding resources, joined before the rest of the loader is destroyed.
+        std::unique_ptr<ResourceLoader> resource_loader;
+
+        std::unique_ptr<FileWatcher> file_watcher;
+
+        std::unique_ptr<ThreadPool> thread_pool;
+
+        // Declared last: systems are destroyed before the rest of the world.
+        std::unique_ptr<Scheduler> scheduler;
+
+        /// Allocate an entity slot without making the entity alive.
+        EntityID reserve_entity();
+
+        /// Same as reserve_entity, but never grows the entity tables, which systems running in parallel may be
+        /// reading: new slots are only counted, and added by grow_reserved_entities. Used by the CommandBuffer,
+        /// under its lock.
+        EntityID reserve_entity_deferred();
+
+        /// Add the table entries of the slots reserved by reserve_entity_deferred. Main thread only.
+        void grow_reserved_entities();
+
+        /// Returns true if the entity exists and has a component of the given TypeId.
+        [[nodiscard]] bool has_component_type(EntityID id, TypeId type_id) const;
+
+        /// Make an entity returned by reserve_entity alive.
+        void activate_entity(EntityID id, const std::string &name);
+
+        /// Give the interned name to the (unnamed) entity.
+        void set_entity_name(EntityID id, NameID name);
+
+        /// Remove the name of the entity slot from the name index, if it has one.
+        void clear_entity_name(EntityIndex index);
+
+        /// Add or remove the tag of the given TypeId from the (existing) entity.
+        void set_tag(EntityID id, TypeId type_id, bool value);
+
+        /// Fill a new query with the matching entities, and register it for updates.
+        void register_query(QueryBase &query);
+
+        /// Update the queries requiring the given component type after it was attached to or detached from the entity.
+        void update_queries(EntityID id, TypeId type_id);
+
+        template<ComponentConcept C, typename F>
+        ObserverID add_observer(const ObserverEvent event, F &&f) {
+            const TypeId type_id = component_type_id<C>();
+            auto &event_observers = observers[event];
+            if (type_id >= event_observers.size())
+                event_observers.resize(type_id + 1);
+
+            const ObserverID id = next_observer_id++;
+            event_observers[type_id].push_back(
+                    {id, [f = std::forward<F>(f)](const EntityID entity, Component &component) mutable {
+                         f(entity, static_cast<C &>(component));
+                     }});
+            return id;
+        }
+
+        /// Returns true if observers are registered for this event on the given component type.
+        [[nodiscard]] bool has_observers(const ObserverEvent event, const TypeId type_id) const {
+            return type_id < observers[event].size() && !observers[event][type_id].empty();
+        }
+
+        /// Call the observers of the event registered for the component type.
+        void notify(const ObserverEvent event, const TypeId type_id, const EntityID id, Component &component) {
+            if (!has_observers(event, type_id))
+                return;
+            for (const Observer &observer: observers[event][type_id])
+                observer.callback(id, component);
+        }
+
+        /// Return the storage of the given component type, or nullptr if none was created yet.
+        template<ComponentConcept C>
+        ComponentStorage<C> *get_storage() {
+            const TypeId type_id = component_type_id<C>();
+            if (type_id >= components.size())
+                return nullptr;
+            return static_cast<ComponentStorage<C> *>(components[type_id].get());
+        }
+
+        /// Return the storage of the given component type, creating it if required.
+        template<ComponentConcept C>
+        ComponentStorage<C> &get_or_create_storage() {
+            const TypeId type_id = component_type_id<C>();
+            if (type_id >= MAX_COMPONENT_TYPES)
+                throw std::runtime_error(std::format("Too many component types (maximum is {})", MAX_COMPONENT_TYPES));
+            if (type_id >= components.size())
+                components.resize(type_id + 1);
+
+            auto &storage = components[type_id];
+            if (!storage)
+                storage = std::make_unique<ComponentStorage<C>>(current_tick);
+            return *static_cast<ComponentStorage<C> *>(storage.get());
+        }
+
+        /// Construct a resource in the storage of its type. name_id is its name in the pool, or NO_NAME.
+        template<ResourceConcept R>
+        Rc<R> make_resource(const std::string &name, const NameID name_id) {
+            std::unique_ptr<Resource> resource;
+            {
+                const TypeConstructionScope<Resource> scope(resource_type_id<R>());
+                resource = std::make_unique<R>(name, *this);
+            }
+
+            ResourceSlot &slot = get_resource_storage(resource_type_id<R>()).insert(std::move(resource), name_id);
+            slot.resource->slot = &slot;
+            return Rc<R>::adopt(&slot);
+        }
+
+        /// Return the storage of the given resource type.
+        ResourceStorage &get_resource_storage(TypeId type_id);
     };
 } // namespace wrld
+
+#include <wrld/CommandBuffer.hpp>
+#include <wrld/Scheduler.hpp>
+#include <wrld/resources/FileWatcher.hpp>
+#include <wrld/resources/ResourceLoader.hpp>
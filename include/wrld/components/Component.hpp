@@ -9,23 +9,33 @@
 #include <string>
 #include <unordered_map>
 
+#include <wrld/Entity.hpp>
+#include <wrld/TypeId.hpp>
 #include <wrld/concepts.hpp>
 
 namespace wrld {
     class Resource;
     class World;
-    typedef size_t EntityID;
 
     template<ResourceConcept>
     class Rc;
+    struct ResourceAttachment;
 
-    class Component : public std::enable_shared_from_this<Component> {
+    class Component {
     public:
-        virtual ~Component() = default;
+        /// Unregisters the component from the resources it uses.
+        virtual ~Component();
         Component(EntityID entity_id, World &world);
 
+        // The resources it uses keep pointers to the attachments
+        Component(const Component &other) = delete;
+        Component &operator=(const Component &other) = delete;
+
         [[nodiscard]] EntityID get_entity() const;
 
+        /// TypeId of the concrete component type (see component_type_id).
+        [[nodiscard]] TypeId get_type_id() const;
+
         virtual std::string get_type() { return "Component"; }
 
         // todo: move to a higher class common with component
@@ -33,6 +43,7 @@ namespace wrld {
 
     protected:
         EntityID entity_id;
+        TypeId type_id;
         World &world;
 
         template<ResourceConcept R>
@@ -41,11 +52,16 @@ namespace wrld {
         template<ResourceConcept R>
         Rc<R> get_resource(const std::string &unique_name) const;
 
+        /// Detach the resource attached under the given name, if any.
         void detach_resource(const std::string &unique_name);
 
+        /// Record that this component was modified (see World::mark_changed).
+        /// Setters of components must call it for change detection to work.
+        void mark_changed() const;
+
         bool has_resource(const std::string &unique_name) const;
 
-        std::unordered_map<std::string, Rc<Resource>> attached_resources;
+        std::unordered_map<std::string, ResourceAttachment> attached_resources;
     };
 } // namespace wrld
 
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <typeindex>
 #include <wrld/components/Component.hpp>
 #include <wrld/resources/Rc.hpp>
 
@@ -8,11 +7,12 @@ namespace wrld {
 
     template<ResourceConcept R>
     void Component::attach_resource(const std::string &unique_name, const Rc<R> &resource) {
-        if (attached_resources.contains(unique_name)) {
-            attached_resources[unique_name].detach_component_user(std::type_index(typeid(*this)), get_entity());
-        }
-        resource.attach_component_user(std::type_index(typeid(*this)), get_entity());
-        attached_resources[unique_name] = resource.template as<Resource>();
+        ResourceAttachment &attachment = attached_resources[unique_name];
+        if (attachment.resource.get() != nullptr)
+            attachment.resource.detach_user(&attachment.user_position);
+
+        resource.attach_component_user(type_id, get_entity(), &attachment.user_position);
+        attachment.resource = resource.template as<Resource>();
     }
 
     template<ResourceConcept R>
@@ -20,6 +20,6 @@ namespace wrld {
         if (!attached_resources.contains(unique_name)) {
             throw std::runtime_error(std::format("Tried to access unbound resource {}", unique_name));
         }
-        return attached_resources.at(unique_name).as<R>();
+        return attached_resources.at(unique_name).resource.as<R>();
     }
 } // namespace wrld
@@ -0,0 +1,25 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/components/Component.hpp>
+
+namespace wrld::cpt {
+    /// Makes the Transform of the entity relative to the Transform of another entity, its parent.
+    /// The model matrix of the entity then becomes the parent's model matrix times its local matrix,
+    /// kept up to date by the HierarchySystem. Both entities need a Transform.
+    class Parent final : public Component {
+    public:
+        Parent(EntityID entity_id, World &world, EntityID parent);
+
+        [[nodiscard]] EntityID get_parent() const;
+        void set_parent(EntityID parent);
+
+        std::string get_type() override { return "Parent"; }
+
+    private:
+        EntityID parent;
+    };
+} // namespace wrld::cpt
@@ -14,12 +14,14 @@ namespace wrld::cpt {
     public:
         StaticModel(EntityID entity_id, World &world, const Rc<rsc::Model> &model);
 
-        [[nodiscard]] Rc<rsc::Model> get_model() const;
+        [[nodiscard]] const Rc<rsc::Model> &get_model() const;
         void set_model(const Rc<rsc::Model> &model);
 
         std::string get_type() override { return "StaticModel"; }
 
     private:
-        // std::shared_ptr<const rsc::Model> model;
+        // Also attached as "model", which registers the component as user and lists it in the GUI.
+        // Kept typed for the renderer, which reads it for every entity on every frame
+        Rc<rsc::Model> model;
     };
 } // namespace wrld::cpt
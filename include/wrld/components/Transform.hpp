@@ -7,9 +7,16 @@
 #include <wrld/components/Component.hpp>
 #include "glm/gtc/quaternion.hpp"
 
+namespace wrld {
+    class HierarchySystem;
+}
+
 namespace wrld::cpt {
 
     /// Gives an Entity a position, a rotation and a scale.
+    /// The model and normal matrices are recomputed when the Transform is modified,
+    /// not each time they are read.
+    /// Position, rotation and scale are relative to the parent entity if there is one (see Parent).
     class Transform final : public Component {
     public:
         // The constructor cannot take other parameters than that
@@ -28,13 +35,23 @@ namespace wrld::cpt {
         void set_scale(const glm::vec3 &scale);
 
         /// Look at a specific point in world space.
+        /// With a parent, the point and up vector are converted to the space of the parent with its model matrix
+        /// as of the last run of the HierarchySystem.
         void look_at(const glm::vec3 &target, const glm::vec3 &up);
 
-        /// Look in a specific direction in world space.
-        /// Equivalent to look_at(position + direction, up).
+        /// Look in a specific direction in world space, converted like in look_at.
+        /// Equivalent to look_at(get_world_position() + direction, up).
         void look_towards(const glm::vec3 &direction, const glm::vec3 &up);
 
+        /// Position in world space, taking the parents into account.
+        [[nodiscard]] glm::vec3 get_world_position() const;
+
+        /// Matrix from local space to world space, taking the parents into account.
         [[nodiscard]] glm::mat4x4 model_matrix() const;
+        /// Transposed inverse of the model matrix, used to transform normals.
+        [[nodiscard]] glm::mat4x4 normal_matrix() const;
+        /// Matrix from local space to the space of the parent (world space if there is none).
+        [[nodiscard]] glm::mat4x4 local_matrix() const;
         [[nodiscard]] glm::mat4x4 translate_matrix() const;
         [[nodiscard]] glm::mat4x4 rotation_matrix() const;
         [[nodiscard]] glm::mat4x4 scale_matrix() const;
@@ -42,9 +59,27 @@ namespace wrld::cpt {
         std::string get_type() override { return "Transform"; }
 
     private:
+        friend class wrld::HierarchySystem;
+
         glm::vec3 position;
         glm::quat rotation;
         glm::vec3 scale;
+
+        // Model matrix of the parent, identity if there is none. Set by the HierarchySystem.
+        glm::mat4x4 parent_matrix = glm::mat4x4(1.0f);
+
+        glm::mat4x4 cached_local_matrix;
+        glm::mat4x4 cached_model_matrix;
+        glm::mat4x4 cached_normal_matrix;
+
+        /// Set the rotation to look at a point, both in the space of the parent.
+        void look_at_local(const glm::vec3 &target, const glm::vec3 &up);
+
+        /// Change the model matrix of the parent, and recompute the model matrix.
+        void set_parent_matrix(const glm::mat4x4 &parent_matrix);
+
+        /// Recompute the cached matrices and mark the component as changed.
+        void update();
     };
 
 } // namespace wrld::cpt
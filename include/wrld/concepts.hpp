@@ -17,4 +17,9 @@ namespace wrld {
     template<class T>
     concept ComponentConcept = std::is_base_of_v<Component, T>;
 
+    /// Concept of a Tag: an empty struct, which is not a Component.
+    /// Tags only exist as a bit in the signature of the entities (see World::add_tag).
+    template<class T>
+    concept TagConcept = std::is_class_v<T> && std::is_empty_v<T> && !std::is_base_of_v<Component, T>;
+
 } // namespace wrld
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <iostream>
+
 #define wrldInfo(txt) (std::cout << "[wrld:info] " << txt << std::endl)
 #define wrldError(txt) (std::cerr << "[wrld:error] " << txt << std::endl)
 #define wrldVar(variable) (std::cout << "[wrld:var] " << #variable << " = " << variable << std::endl)
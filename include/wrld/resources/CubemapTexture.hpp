@@ -5,6 +5,7 @@
 #pragma once
 
 #include <wrld/resources/Resource.hpp>
+#include <wrld/resources/Texture.hpp>
 #include "glad/glad.h"
 
 
@@ -15,10 +16,15 @@ namespace wrld::rsc {
     class CubemapTexture final : public Resource {
     public:
         /// Order of textures: +X, -X, +Y, -Y, +Z, -Z
+        /// Until set_texture is called, the default cubemap is used instead.
         explicit CubemapTexture(std::string name, World &world /*, Rc<Resource> *rc*/);
 
         CubemapTexture &set_texture(const std::vector<std::string> &cubemap_paths);
 
+        /// Same as set_texture, but the files are decoded by a worker thread and the images uploaded during a later
+        /// frame (see ResourceLoader). The cubemap keeps its current images until then.
+        CubemapTexture &set_texture_async(const std::vector<std::string> &cubemap_paths);
+
         CubemapTexture(CubemapTexture &other) = delete;
         CubemapTexture(CubemapTexture &&other) = delete;
         CubemapTexture &operator=(CubemapTexture &other) = delete;
@@ -30,8 +36,27 @@ namespace wrld::rsc {
 
         std::string get_type() const override { return "CubemapTexture"; }
 
+        /// Load the face files again, in the background (see set_texture_async).
+        void reload_async() override;
+
     private:
         GLuint gl_texture;
+        // Files of the faces, empty until set_texture is called
+        std::vector<std::string> paths;
+
+        /// Remember the files of the faces, and reload the cubemap when they change (see FileWatcher).
+        void watch(const std::vector<std::string> &cubemap_paths);
+
+        /// Decode the image of each face. Does not use OpenGL, so it can be called from any thread.
+        static std::vector<TextureImage> decode(const std::vector<std::string> &cubemap_paths);
+
+        /// Send the faces to the GPU, creating the texture if required.
+        void upload(const std::vector<TextureImage> &faces);
+
+        /// Delete the GL texture. The faces are decoded again from their files on the next use.
+        bool evict_gpu_memory() override;
+
+        void restore_gpu_memory() override;
     };
 
 } // namespace wrld::rsc
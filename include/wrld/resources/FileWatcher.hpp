@@ -0,0 +1,87 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/TypeId.hpp>
+#include <wrld/resources/Rc.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wrld {
+    class World;
+
+    /// Reloads the resources whose files changed on disk (hot reload), using inotify. Only supported on Linux.
+    ///
+    /// Resources register the files they are loaded from (see watch), and are reloaded with
+    /// Resource::reload_async when one of them is written: decoding happens on the worker threads, and the
+    /// GPU objects are replaced during a later frame (see ResourceLoader), so editing files never stalls a frame.
+    /// Directories are watched instead of files, so that files replaced by editors (written then renamed) are seen.
+    class FileWatcher {
+    public:
+        explicit FileWatcher(World &world);
+
+        FileWatcher(const FileWatcher &other) = delete;
+        FileWatcher &operator=(const FileWatcher &other) = delete;
+
+        ~FileWatcher();
+
+        /// Start or stop watching the files. Disabled by default.
+        /// Files registered while disabled are watched once enabled.
+        /// Throws std::runtime_error if file watching is not supported.
+        void set_enabled(bool enabled);
+
+        /// Takes no lock.
+        [[nodiscard]] bool is_enabled() const;
+
+        /// Reload the resource when the file at the given path changes.
+        /// The watch is dropped once the resource is destroyed; it does not keep the resource alive.
+        /// Does nothing if the Rc is empty (see Resource::get_rc).
+        /// May be called from any thread, as resources may be loaded by worker threads.
+        void watch(const std::string &path, const Rc<Resource> &resource);
+
+        /// Read the pending changes, and reload the resources using the changed files, each at most once.
+        /// Every PRUNE_INTERVAL calls, also drop the watches of destroyed resources.
+        /// Never blocks. Return the amount of reloaded resources. Called each frame by Main.
+        size_t poll();
+
+    private:
+        /// Amount of polls between two removals of the watches of destroyed resources.
+        static constexpr size_t PRUNE_INTERVAL = 64;
+
+        struct Watch {
+            TypeId type_id;
+            ResourceHandle handle;
+
+            bool operator==(const Watch &other) const = default;
+        };
+
+        World &world;
+
+        // Guards inotify_fd, directories and watch_directories
+        std::mutex mutex;
+        // inotify instance, -1 while disabled
+        int inotify_fd = -1;
+        // Whether inotify_fd is open, read without the lock
+        std::atomic<bool> enabled = false;
+        // Polls since the watches were last pruned
+        size_t polls_since_prune = 0;
+        // Resources to reload, by watched directory and file name
+        std::unordered_map<std::string, std::unordered_map<std::string, std::vector<Watch>>> directories;
+        // Watched directory of each inotify watch descriptor
+        std::unordered_map<int, std::string> watch_directories;
+
+        /// Add the inotify watch of the directory.
+        void watch_directory(const std::string &directory);
+
+        /// Drop the watches of destroyed resources. The resources still alive are added to acquired, so that
+        /// they are released once the lock is released.
+        void prune(std::vector<Rc<Resource>> &acquired);
+    };
+} // namespace wrld
@@ -0,0 +1,93 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace wrld {
+    class Resource;
+
+    /// Accounts for the GPU memory used by the resources of a World, and keeps it within a budget by evicting the
+    /// least recently used resources (see Resource::evict_gpu_memory). Evicted resources keep what is needed to be
+    /// uploaded again (CPU copy or file), which happens transparently on their next use.
+    ///
+    /// Resources report their GPU memory with track when uploading, and their uses with touch when drawn.
+    /// Evictable resources are kept in a list ordered by last use, so that touching and evicting cost O(1).
+    /// Only used by the main thread, like OpenGL.
+    class GpuMemory {
+    public:
+        /// Entry of resources not tracked (see Resource::gpu_entry).
+        static constexpr uint32_t NO_ENTRY = std::numeric_limits<uint32_t>::max();
+
+        GpuMemory() = default;
+
+        GpuMemory(const GpuMemory &other) = delete;
+        GpuMemory &operator=(const GpuMemory &other) = delete;
+
+        /// Set the amount of GPU memory the resources should fit in, in bytes. 0, the default, disables eviction.
+        void set_budget(size_t bytes);
+
+        [[nodiscard]] size_t get_budget() const;
+
+        /// Set for how many frames a resource must stay unused before being evicted. Default to 120.
+        void set_eviction_delay(uint64_t frames);
+
+        /// Amount of GPU memory used by the resources, in bytes.
+        [[nodiscard]] size_t get_used() const;
+
+        /// Record the amount of GPU memory now used by the resource, and mark it as used.
+        /// Resources which must stay on the GPU, like framebuffers, are not evictable.
+        void track(Resource &resource, size_t bytes, bool evictable = true);
+
+        /// Stop tracking the resource. Called when it is destroyed.
+        void untrack(Resource &resource);
+
+        /// Mark the resource as used during this frame. If it was evicted, upload it again
+        /// (see Resource::restore_gpu_memory).
+        void touch(const Resource &resource);
+
+        /// While over budget, evict the least recently used resources not used for the eviction delay.
+        /// Then start a new frame. Return the amount of evicted resources. Called each frame by Main.
+        size_t evict();
+
+    private:
+        struct Entry {
+            Resource *resource = nullptr;
+            size_t bytes = 0;
+            // Frame of the last use
+            uint64_t last_use = 0;
+            // Neighbours in the list of evictable entries
+            uint32_t previous = NO_ENTRY;
+            uint32_t next = NO_ENTRY;
+            bool evictable = false;
+            // In the list of evictable entries: evictable, uploaded and not evicted
+            bool linked = false;
+            // Evicted and not used since
+            bool evicted = false;
+        };
+
+        size_t budget = 0;
+        size_t used = 0;
+        uint64_t eviction_delay = 120;
+        uint64_t frame = 0;
+
+        // Entries of the tracked resources, indexed by Resource::gpu_entry
+        std::vector<Entry> entries;
+        std::vector<uint32_t> free_entries;
+
+        // Least and most recently used evictable entries
+        uint32_t first = NO_ENTRY;
+        uint32_t last = NO_ENTRY;
+
+        /// Append the entry to the list of evictable entries, as the most recently used.
+        void link(uint32_t index);
+
+        /// Remove the entry from the list of evictable entries.
+        void unlink(uint32_t index);
+    };
+} // namespace wrld
@@ -9,11 +9,17 @@
 #include <wrld/resources/Mesh.hpp>
 #include <wrld/resources/Texture.hpp>
 
+#include <array>
 #include <memory>
+#include <span>
 #include <unordered_map>
 #include <vector>
 #include <glm/mat4x4.hpp>
 
+namespace Assimp {
+    class Importer;
+}
+
 // todo: it may be easier to have subclasses "FileModel" (loaded from 3D file)
 // and "MeshModel" (loaded from a mesh in memory)
 
@@ -27,7 +33,7 @@ namespace wrld::rsc {
         [[nodiscard]] glm::vec3 size() const { return upper - lower; }
 
         /// Return each vertices of the bounding box.
-        [[nodiscard]] std::vector<glm::vec3> vertices() const;
+        [[nodiscard]] std::array<glm::vec3, 8> vertices() const;
     };
 
     class MeshGraphNode {
@@ -47,19 +53,39 @@ namespace wrld::rsc {
     public:
         explicit Model(std::string name, World &world);
 
+        ~Model() override;
+
         /// Loads model from file
         Model &from_file(const std::string &model_path, unsigned ai_flags = 0, bool flip_textures = false,
                          const std::optional<Rc<Material>> &custom_material = std::nullopt);
 
+        /// Same as from_file, but the file is parsed and its meshes, materials and geometry built by a worker thread;
+        /// only the upload happens during a later frame (see ResourceLoader). Its textures are loaded in the
+        /// background too.
+        /// The model keeps its current content until then (none if it was just created, like the default model).
+        Model &from_file_async(const std::string &model_path, unsigned ai_flags = 0, bool flip_textures = false,
+                               const std::optional<Rc<Material>> &custom_material = std::nullopt);
+
         /// Creates a Model with a single mesh
         Model &from_mesh(const Rc<Mesh> &mesh);
 
+        /// Creates a Model from already aggregated geometry (see Snapshot), without any Mesh resource.
+        /// The i-th mesh covers meshes_size[i] elements from meshes_start[i],
+        /// and uses materials[mesh_materials[i]].
+        Model &from_geometry(std::span<const Vertex> vertices, std::span<const VertexID> elements,
+                             std::span<const uint64_t> meshes_start, std::span<const uint64_t> meshes_size,
+                             std::span<const uint32_t> mesh_materials, const std::vector<Rc<Material>> &materials);
+
         [[nodiscard]] size_t get_mesh_count() const;
 
         [[nodiscard]] const std::shared_ptr<MeshGraphNode> &get_root_mesh() const;
 
         std::string get_type() const override { return "Model"; }
 
+        /// Load the model file again, in the background (see from_file_async). Its textures are reloaded on their
+        /// own when their files change.
+        void reload_async() override;
+
         const std::vector<Rc<Material>> &get_materials() const;
 
         const std::vector<Rc<Mesh>> &get_meshes() const;
@@ -110,6 +136,30 @@ namespace wrld::rsc {
 
         ////// BELOW : Data & functions when model is loaded from file
 
+        /// Aggregated geometry of the meshes of a model (see aggregate_meshes).
+        struct Geometry {
+            std::vector<Vertex> vertices;
+            std::vector<VertexID> elements;
+            std::vector<size_t> meshes_start;
+            std::vector<size_t> meshes_size;
+            std::unordered_map<std::string, std::vector<unsigned>> material_meshes;
+            BoundingBox local_bb;
+        };
+
+        /// Everything a model file is made of, built without OpenGL nor the model (see SceneBuilder),
+        /// then given to the model at once by set_scene.
+        struct Scene {
+            std::shared_ptr<MeshGraphNode> root_mesh;
+            std::vector<Rc<Mesh>> meshes;
+            std::vector<Rc<Material>> materials;
+            // Textures of the materials, by path
+            std::unordered_map<std::string, Rc<Texture>> textures;
+            Geometry geometry;
+        };
+
+        /// Creates the materials, textures and meshes of a scene. Defined in Model.cpp.
+        class SceneBuilder;
+
         // Cache loaded textures
         std::unordered_map<std::string, Rc<Texture>> loaded_textures;
         // Loaded materials
@@ -128,18 +178,29 @@ namespace wrld::rsc {
 
         void reload_from_file();
 
-        /// Compute local bounding box of this mesh.
-        BoundingBox compute_local_bb() const;
+        /// Parse the model file. Does not use OpenGL or the World, so it can be called from any thread.
+        /// The scene is owned by the importer.
+        static const aiScene *read_scene(Assimp::Importer &importer, const std::string &model_path, unsigned ai_flags);
+
+        /// Replace the content of the model with the built scene, and upload it.
+        void set_scene(Scene &&scene);
+
+        /// Aggregate the vertices and elements of the meshes. Does not use OpenGL, so it can be called from any
+        /// thread, as long as the meshes are not modified meanwhile.
+        static Geometry aggregate_meshes(const std::vector<Rc<Mesh>> &meshes);
+
+        /// Replace the geometry of the model, and upload it.
+        void set_geometry(Geometry &&geometry);
 
-        std::vector<Rc<Material>> load_materials(const aiScene *scene);
+        /// Send vertices and elements to the GPU, creating the VAO/VBO/EBO if required.
+        void upload();
 
-        std::shared_ptr<MeshGraphNode> process_node(const aiNode *node, const aiScene *scene);
+        /// Delete the VAO/VBO/EBO. They are uploaded again from the vertices and elements on the next draw.
+        bool evict_gpu_memory() override;
 
-        Rc<Mesh> process_mesh(const aiMesh *mesh);
+        void restore_gpu_memory() override;
 
-        /// Load textures of the given type from aiMaterial.
-        /// Will only return a maximum of max textures.
-        std::vector<Rc<Texture>> load_textures(const aiMaterial *material, aiTextureType type, const aiScene *scene,
-                                               bool flip_textures, unsigned max = 1);
+        /// Compute the bounding box of the vertices, in their space.
+        static BoundingBox compute_local_bb(std::span<const Vertex> vertices);
     };
 } // namespace wrld::rsc
@@ -29,6 +29,10 @@ namespace wrld::rsc {
         /// Loads a shader separated in 2 files (one vertex, one fragment).
         Program &from_file(const std::string &vertex_path, const std::string &fragment_path);
 
+        /// Same as from_file, but the files are read by a worker thread and the program compiled during a later
+        /// frame (see ResourceLoader). The program uses the default shaders until then.
+        Program &from_file_async(const std::string &vertex_path, const std::string &fragment_path);
+
         /// Loads a shader source in which both shaders (vertex & fragment)
         /// are defined (using #ifdef directives) to create the program.
         Program &from_source(const std::string &combined_shader_src);
@@ -44,7 +48,7 @@ namespace wrld::rsc {
 
         ~Program() override;
 
-        /// Use this program in the GL context.
+        /// Use this program in the GL context. Programs not compiled yet use the default shaders.
         void use() const;
 
         void set_uniform(const std::string &uniform, float value) const;
@@ -63,23 +67,32 @@ namespace wrld::rsc {
 
         void set_uniform(const std::string &uniform, const Material &material) const;
 
-        void reload() const;
+        /// Recompile the program from its files in the background, if it was loaded with from_file: the files are
+        /// read by a worker thread, and the program replaced during a later frame (see ResourceLoader).
+        /// The current program stays in use until then, or if the new one fails to compile.
+        void reload_async() override;
 
         std::string get_type() const override { return "Program"; }
 
     private:
-        std::string vertex_shader_path = "wrld/shaders/vertex/default.glsl";
-        std::string fragment_shader_path = "wrld/shaders/fragment/default.glsl";
+        // Empty if the program was not loaded from files
+        std::string vertex_shader_path;
+        std::string fragment_shader_path;
 
-        GLuint vertex_shader = 0;
-        GLuint fragment_shader = 0;
-        GLuint gl_program = 0;
+        // Compiled lazily by use (const), from the default shaders if nothing was loaded yet. Like every
+        // OpenGL object, only accessed by the main thread
+        mutable GLuint vertex_shader = 0;
+        mutable GLuint fragment_shader = 0;
+        mutable GLuint gl_program = 0;
 
         static std::string read_file(const std::string &path);
 
-        bool compiled_once = false;
+        mutable bool compiled_once = false;
         void reload_from_file();
-        void reload_from_source(const std::string &vertex_src, const std::string &fragment_src);
+
+        /// Compile and link the shaders into new GL objects, which replace the current ones only if successful.
+        /// Main thread only.
+        void reload_from_source(const std::string &vertex_src, const std::string &fragment_src) const;
 
         /// Preprocess the GLSL source code to fit our needs.
         /// We add a #define with the expected type of the shader. This allows to
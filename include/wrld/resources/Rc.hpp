@@ -5,91 +5,113 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
+#include <span>
+#include <string>
 #include <vector>
-#include <ranges>
-#include <typeindex>
 
+#include <wrld/Entity.hpp>
+#include <wrld/TypeId.hpp>
 #include <wrld/concepts.hpp>
-
-#include <unordered_set>
+#include <wrld/resources/ResourceStorage.hpp>
 
 namespace wrld {
     class World;
     class Resource;
     class Component;
-    typedef size_t EntityID;
 
-    /// ResourceCounter
+    /// Reference-counted handle to a resource of a World.
+    /// An Rc points to the slot of the resource in the ResourceStorage of its type, which holds
+    /// the reference count: it is the size of a pointer, and accessing the resource costs no lookup.
+    /// The resource is destroyed when the last Rc referencing it is.
+    /// An Rc must not outlive its World.
     template<ResourceConcept R>
     class Rc {
-        typedef std::unordered_map<std::type_index, std::unordered_set<EntityID>> UserComponentPool;
-        typedef std::unordered_map<std::type_index, std::unordered_set<std::string>> UserResourcePool;
-
     public:
-        Rc();
+        Rc() = default;
 
-        Rc(std::string name, World &world);
+        /// Take a new reference to the slot, which must hold a resource of type R (or derived from it).
+        explicit Rc(ResourceSlot *slot);
 
-        Rc(std::shared_ptr<R> ptr, std::shared_ptr<UserComponentPool> comp_users,
-           std::shared_ptr<UserResourcePool> res_users);
+        Rc(const Rc &other);
 
-        R *operator->() const;
+        Rc(Rc &&other) noexcept;
 
-        const R *get() const;
+        Rc &operator=(const Rc &other);
 
-        R *get_mut() const;
+        Rc &operator=(Rc &&other) noexcept;
 
-        std::shared_ptr<R> get_ptr() const;
+        ~Rc();
 
-        R &get_ref() const;
+        /// Wrap a slot whose reference was already taken (see ResourceStorage::acquire).
+        static Rc adopt(ResourceSlot *slot);
 
-        template<ComponentConcept T>
-        void attach_component_user(EntityID id) const;
+        R *operator->() const;
 
-        void attach_component_user(const std::type_index &ti, EntityID id) const;
+        const R *get() const;
 
-        template<ComponentConcept T>
-        void detach_component_user(EntityID id) const;
+        R *get_mut() const;
 
-        void detach_component_user(const std::type_index &ti, EntityID id) const;
+        R &get_ref() const;
 
-        template<ResourceConcept T>
-        void attach_resource_user(const std::string &name) const;
+        /// Return the compact handle of the resource, which does not keep it alive.
+        [[nodiscard]] ResourceHandle get_handle() const;
 
-        void attach_resource_user(const std::type_index &ti, const std::string &name) const;
+        /// Register a component as user of the resource. position receives its position in the users list,
+        /// and must stay at the same address until detach_user.
+        void attach_component_user(TypeId type_id, EntityID id, uint32_t *position) const;
 
-        template<ResourceConcept T>
-        void detach_resource_user(const std::string &name) const;
+        /// Register a resource as user of the resource (see attach_component_user).
+        void attach_resource_user(TypeId type_id, const Resource *user, uint32_t *position) const;
 
-        void detach_resource_user(const std::type_index &ti, const std::string &name) const;
+        /// Remove the user whose position is stored at the given address (see attach_component_user).
+        void detach_user(const uint32_t *position) const;
 
+        /// Return the components and resources using the resource.
+        [[nodiscard]] const ResourceUsers &get_users() const;
+
+        /// Return the entities whose component of type T uses the resource.
         template<ComponentConcept T>
-        const std::unordered_set<EntityID> &get_users() const;
+        [[nodiscard]] std::vector<EntityID> get_users() const;
 
+        /// Return the names of the resources of type T using the resource.
         template<ResourceConcept T>
-        const std::unordered_set<std::string> &get_users() const;
+        [[nodiscard]] std::vector<std::string> get_users() const;
 
+        /// Return the given entities whose component of type T uses the resource, in the order of the list.
         template<ComponentConcept T>
-        std::vector<EntityID> get_common_users(const std::vector<std::shared_ptr<const T>> &list) const;
+        std::vector<EntityID> get_common_users(std::span<const EntityID> entities) const;
 
+        /// Return the names of the given resources which use the resource.
         template<ResourceConcept T>
         std::vector<std::string> get_common_users(const std::vector<Rc<T>> &list) const;
 
+        /// Return an Rc to the same resource, as type T.
+        /// The type is checked with the TypeId stored in the slot, without RTTI:
+        /// throws std::bad_cast if T is neither Resource nor the type of the resource.
         template<ResourceConcept T>
         Rc<T> as() const;
 
-        template<ResourceConcept T>
-        Rc<T> *as_ptr();
-
-        /// Delete this Rc's shared ptrs.
-        /// It must not be used after this call.
+        /// Release this Rc's reference. It must not be used after this call.
         void invalidate();
 
+        bool operator==(const Rc &other) const;
+
     private:
-        std::shared_ptr<R> resource;
-        std::shared_ptr<UserComponentPool> component_users;
-        std::shared_ptr<UserResourcePool> resource_users;
+        template<ResourceConcept>
+        friend class Rc;
+
+        ResourceSlot *slot = nullptr;
+
+        /// Drop the reference to the slot, destroying the resource if it was the last one.
+        void release();
+    };
+
+    /// A resource attached under a name to a component or a resource (see Component::attach_resource),
+    /// which is registered as one of its users.
+    struct ResourceAttachment {
+        Rc<Resource> resource;
+        /// Position of the user in the users list of the resource.
+        uint32_t user_position = 0;
     };
 } // namespace wrld
 
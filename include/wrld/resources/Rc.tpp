@@ -7,145 +7,149 @@
 #include <wrld/components/Component.hpp>
 #include <wrld/resources/Resource.hpp>
 
+#include <algorithm>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
 namespace wrld {
     template<ResourceConcept R>
-    Rc<R>::Rc() : component_users({}), resource_users({}) {}
+    Rc<R>::Rc(ResourceSlot *slot) : slot(slot) {
+        if (slot != nullptr)
+            slot->references.fetch_add(1, std::memory_order_relaxed);
+    }
 
     template<ResourceConcept R>
-    Rc<R>::Rc(std::string name, World &world) {
-        this->component_users = std::make_shared<UserComponentPool>();
-        this->resource_users = std::make_shared<UserResourcePool>();
-        resource = std::make_shared<R>(name, world /*, this->as_ptr<Resource>()*/);
-        // resource->load_default_resources();
-    }
+    Rc<R>::Rc(const Rc &other) : Rc(other.slot) {}
 
     template<ResourceConcept R>
-    Rc<R>::Rc(std::shared_ptr<R> ptr, std::shared_ptr<UserComponentPool> comp_users,
-              std::shared_ptr<UserResourcePool> res_users) :
-        resource(std::move(ptr)), component_users(std::move(comp_users)), resource_users(std::move(res_users)) {}
+    Rc<R>::Rc(Rc &&other) noexcept : slot(std::exchange(other.slot, nullptr)) {}
 
     template<ResourceConcept R>
-    R *Rc<R>::operator->() const {
-        return resource.get();
+    Rc<R> &Rc<R>::operator=(const Rc &other) {
+        if (slot != other.slot) {
+            Rc copy(other);
+            std::swap(slot, copy.slot);
+        }
+        return *this;
     }
 
-    // template<ResourceConcept R>
-    // R *Rc<R>::operator->() {
-    //     return resource.get();
-    // }
-
     template<ResourceConcept R>
-    const R *Rc<R>::get() const {
-        return resource.get();
+    Rc<R> &Rc<R>::operator=(Rc &&other) noexcept {
+        if (this != &other) {
+            release();
+            slot = std::exchange(other.slot, nullptr);
+        }
+        return *this;
     }
 
     template<ResourceConcept R>
-    R *Rc<R>::get_mut() const {
-        return resource.get();
+    Rc<R>::~Rc() {
+        release();
     }
 
     template<ResourceConcept R>
-    std::shared_ptr<R> Rc<R>::get_ptr() const {
-        return resource;
+    Rc<R> Rc<R>::adopt(ResourceSlot *slot) {
+        Rc res;
+        res.slot = slot;
+        return res;
     }
 
     template<ResourceConcept R>
-    R &Rc<R>::get_ref() const {
-        return *resource;
+    R *Rc<R>::operator->() const {
+        return get_mut();
     }
 
     template<ResourceConcept R>
-    template<ComponentConcept T>
-    void Rc<R>::attach_component_user(const EntityID id) const {
-        const auto &type_index = std::type_index(typeid(T));
-        attach_component_user(type_index, id);
+    const R *Rc<R>::get() const {
+        return get_mut();
     }
 
     template<ResourceConcept R>
-    void Rc<R>::attach_component_user(const std::type_index &ti, const EntityID id) const {
-        if (!component_users->contains(ti)) {
-            component_users->insert_or_assign(ti, std::unordered_set<EntityID>());
-        }
-        component_users->at(ti).insert(id);
+    R *Rc<R>::get_mut() const {
+        return slot == nullptr ? nullptr : static_cast<R *>(slot->resource.get());
     }
 
     template<ResourceConcept R>
-    template<ComponentConcept T>
-    void Rc<R>::detach_component_user(const EntityID id) const {
-        const auto &type_index = std::type_index(typeid(T));
-        detach_component_user(type_index, id);
+    R &Rc<R>::get_ref() const {
+        return *get_mut();
     }
 
     template<ResourceConcept R>
-    void Rc<R>::detach_component_user(const std::type_index &ti, const EntityID id) const {
-        if (!component_users->contains(ti))
-            return;
-        component_users->at(ti).erase(id);
+    ResourceHandle Rc<R>::get_handle() const {
+        return slot == nullptr ? ResourceHandle() : slot->handle;
     }
 
     template<ResourceConcept R>
-    template<ResourceConcept T>
-    void Rc<R>::attach_resource_user(const std::string &name) const {
-        const auto &type_index = std::type_index(typeid(T));
-        attach_resource_user(type_index, name);
+    void Rc<R>::attach_component_user(const TypeId type_id, const EntityID id, uint32_t *position) const {
+        slot->users.add_component_user(type_id, id, position);
     }
 
     template<ResourceConcept R>
-    void Rc<R>::attach_resource_user(const std::type_index &ti, const std::string &name) const {
-        if (!resource_users->contains(ti)) {
-            resource_users->insert_or_assign(ti, std::unordered_set<std::string>());
-        }
-        resource_users->at(ti).insert(name);
+    void Rc<R>::attach_resource_user(const TypeId type_id, const Resource *user, uint32_t *position) const {
+        slot->users.add_resource_user(type_id, user, position);
     }
 
     template<ResourceConcept R>
-    template<ResourceConcept T>
-    void Rc<R>::detach_resource_user(const std::string &name) const {
-        const auto &type_index = std::type_index(typeid(T));
-        detach_resource_user(type_index, name);
+    void Rc<R>::detach_user(const uint32_t *position) const {
+        slot->users.remove(position);
     }
 
     template<ResourceConcept R>
-    void Rc<R>::detach_resource_user(const std::type_index &ti, const std::string &name) const {
-        if (!resource_users->contains(ti))
-            return;
-        resource_users->at(ti).erase(name);
+    const ResourceUsers &Rc<R>::get_users() const {
+        return slot->users;
     }
 
     template<ResourceConcept R>
     template<ComponentConcept T>
-    const std::unordered_set<EntityID> &Rc<R>::get_users() const {
-        const auto &type_index = std::type_index(typeid(T));
-        if (!component_users->contains(type_index))
-            component_users->insert_or_assign(type_index, std::unordered_set<EntityID>());
+    std::vector<EntityID> Rc<R>::get_users() const {
+        const TypeId type_id = component_type_id<T>();
+        std::vector<EntityID> res;
+        for (const ResourceUser &user: slot->users.get_users()) {
+            if (user.resource == nullptr && user.type_id == type_id)
+                res.push_back(user.entity);
+        }
 
-        return component_users->at(type_index);
+        // A component may use the resource under several names
+        std::ranges::sort(res);
+        const auto duplicates = std::ranges::unique(res);
+        res.erase(duplicates.begin(), duplicates.end());
+        return res;
     }
 
     template<ResourceConcept R>
     template<ResourceConcept T>
-    const std::unordered_set<std::string> &Rc<R>::get_users() const {
-        const auto &type_index = std::type_index(typeid(T));
-        if (!resource_users->contains(type_index))
-            resource_users->insert_or_assign(type_index, std::unordered_set<std::string>());
+    std::vector<std::string> Rc<R>::get_users() const {
+        const TypeId type_id = resource_type_id<T>();
+        std::vector<const Resource *> users;
+        for (const ResourceUser &user: slot->users.get_users()) {
+            if (user.resource != nullptr && user.type_id == type_id)
+                users.push_back(user.resource);
+        }
+
+        std::ranges::sort(users);
+        const auto duplicates = std::ranges::unique(users);
+        users.erase(duplicates.begin(), duplicates.end());
 
-        return resource_users->at(type_index);
+        std::vector<std::string> res;
+        res.reserve(users.size());
+        for (const Resource *user: users)
+            res.push_back(user->get_name());
+        return res;
     }
 
     template<ResourceConcept R>
     template<ComponentConcept T>
-    std::vector<EntityID> Rc<R>::get_common_users(const std::vector<std::shared_ptr<const T>> &list) const {
-        const auto &type_index = std::type_index(typeid(T));
-        if (!component_users->contains(type_index))
-            return {};
+    std::vector<EntityID> Rc<R>::get_common_users(const std::span<const EntityID> entities) const {
+        // Sorted, to look each entity up without hashing
+        const std::vector<EntityID> users = get_users<T>();
 
         std::vector<EntityID> res{};
-        res.reserve(list.size());
+        res.reserve(std::min(entities.size(), users.size()));
 
-        for (const auto &e: list) {
-            if (component_users->at(type_index).contains(e->get_entity())) {
-                res.push_back(e.get()->get_entity());
-            }
+        for (const EntityID entity: entities) {
+            if (std::ranges::binary_search(users, entity))
+                res.push_back(entity);
         }
 
         return res;
@@ -154,18 +158,20 @@ namespace wrld {
     template<ResourceConcept R>
     template<ResourceConcept T>
     std::vector<std::string> Rc<R>::get_common_users(const std::vector<Rc<T>> &list) const {
-        const auto &type_index = std::type_index(typeid(T));
-        if (!resource_users->contains(type_index))
-            return {};
+        const TypeId type_id = resource_type_id<T>();
+        std::vector<const Resource *> users;
+        for (const ResourceUser &user: slot->users.get_users()) {
+            if (user.resource != nullptr && user.type_id == type_id)
+                users.push_back(user.resource);
+        }
+        std::ranges::sort(users);
 
         std::vector<std::string> res{};
-        res.reserve(list.size());
+        res.reserve(std::min(list.size(), users.size()));
 
         for (const auto &e: list) {
-            const std::string &name = e.get()->get_name();
-            if (resource_users->at(type_index).contains(name)) {
-                res.push_back(name);
-            }
+            if (std::ranges::binary_search(users, static_cast<const Resource *>(e.get())))
+                res.push_back(e->get_name());
         }
 
         return res;
@@ -174,34 +180,30 @@ namespace wrld {
     template<ResourceConcept R>
     template<ResourceConcept T>
     Rc<T> Rc<R>::as() const {
-        auto casted = std::dynamic_pointer_cast<T>(resource);
-        if (!casted) {
-            throw std::bad_cast();
+        if constexpr (!std::is_same_v<T, Resource>) {
+            if (slot != nullptr && slot->type_id != resource_type_id<T>())
+                throw std::bad_cast();
         }
-        return Rc<T>(casted, component_users, resource_users);
+        return Rc<T>(slot);
     }
 
     template<ResourceConcept R>
-    template<ResourceConcept T>
-    Rc<T> *Rc<R>::as_ptr() {
-        return reinterpret_cast<Rc<T> *>(this);
+    void Rc<R>::invalidate() {
+        release();
     }
 
     template<ResourceConcept R>
-    void Rc<R>::invalidate() {
-        resource.reset();
-        component_users.reset();
-        resource_users.reset();
-    }
-
-    // template<ResourceConcept R>
-    // template<ResourceConcept T>
-    // std::shared_ptr<Rc<T>> Rc<R>::as_ptr() const {
-    //     auto casted = std::dynamic_pointer_cast<T>(resource);
-    //     if (!casted) {
-    //         throw std::bad_cast();
-    //     }
-    //     // Wrap the Rc<T> in a shared_ptr
-    //     return std::make_shared<Rc<T>>(casted, component_users, resource_users);
-    // }
+    bool Rc<R>::operator==(const Rc &other) const {
+        return slot == other.slot;
+    }
+
+    template<ResourceConcept R>
+    void Rc<R>::release() {
+        if (slot == nullptr)
+            return;
+
+        ResourceSlot *released = std::exchange(slot, nullptr);
+        if (released->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            released->storage->release(*released);
+    }
 } // namespace wrld
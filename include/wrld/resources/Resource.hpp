@@ -10,8 +10,10 @@
 #include <iostream>
 #include <unordered_map>
 
+#include <wrld/TypeId.hpp>
 #include <wrld/concepts.hpp>
 #include <wrld/logs.hpp>
+#include <wrld/resources/GpuMemory.hpp>
 
 namespace wrld {
     class Component;
@@ -19,28 +21,64 @@ namespace wrld {
 
     template<ResourceConcept>
     class Rc;
+    struct ResourceAttachment;
+    struct ResourceSlot;
 
-    class Resource : public std::enable_shared_from_this<Resource> {
+    /// Base class of the resources. Resources are created by the World, stored in the
+    /// ResourceStorage of their type and accessed through Rc.
+    class Resource {
     public:
-        virtual ~Resource() { /*wrldInfo(std::format("Resource '{}' got freed", get_name()));*/ }
+        /// Unregisters the resource from the resources it uses.
+        virtual ~Resource();
 
         explicit Resource(std::string name, World &world /*, Rc<Resource> *rc*/);
 
+        // The resources it uses keep pointers to the attachments
+        Resource(const Resource &other) = delete;
+        Resource &operator=(const Resource &other) = delete;
+
         // todo: move to a higher class common with component
         // todo: DO THE SAME FOR COMPONENTS
         // virtual void load_default_resources() = 0;
 
         [[nodiscard]] std::string get_name() const;
 
+        /// TypeId of the concrete resource type (see resource_type_id).
+        [[nodiscard]] TypeId get_type_id() const;
+
+        /// Return an Rc to this resource. Empty while the resource is being constructed.
+        [[nodiscard]] Rc<Resource> get_rc() const;
+
+        /// Return true for the default resources (see World::get_default).
+        [[nodiscard]] bool is_default() const;
+
         virtual std::string get_type() const { return "Resource"; }
 
+        /// Reload the resource from the files it was loaded from, without blocking (see ResourceLoader).
+        /// Called by the FileWatcher when one of them changed. Does nothing for resources not loaded from files.
+        virtual void reload_async() {}
+
     protected:
         friend class Rc<Resource>;
         friend class Component;
+        friend class World;
+        friend class GpuMemory;
         std::string name;
+        TypeId type_id;
         World &world;
+        // Slot storing the resource, set by the World once the resource is constructed
+        ResourceSlot *slot = nullptr;
+        // Entry of the resource in the GpuMemory of the World, if it uses GPU memory
+        uint32_t gpu_entry = GpuMemory::NO_ENTRY;
         // Rc<Resource> *rc;
 
+        /// Free the GPU memory of the resource, keeping what is needed to upload it again. Called by GpuMemory
+        /// when over budget. Return false if the resource can not be evicted, like default resources.
+        virtual bool evict_gpu_memory() { return false; }
+
+        /// Upload the resource again after evict_gpu_memory, possibly in the background. Called on its next use.
+        virtual void restore_gpu_memory() {}
+
         /// Attach a resource R to this object.
         /// This resource will be later accessible via get_resource.
         template<ResourceConcept R>
@@ -49,11 +87,12 @@ namespace wrld {
         template<ResourceConcept R>
         Rc<R> get_resource(const std::string &unique_name) const;
 
+        /// Detach the resource attached under the given name, if any.
         void detach_resource(const std::string &unique_name);
 
         bool has_resource(const std::string &unique_name) const;
 
-        std::unordered_map<std::string, Rc<Resource>> attached_resources;
+        std::unordered_map<std::string, ResourceAttachment> attached_resources;
     };
 } // namespace wrld
 
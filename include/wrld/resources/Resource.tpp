@@ -6,18 +6,16 @@
 
 #include <wrld/resources/Rc.hpp>
 
-#include <typeindex>
-
 namespace wrld {
 
     template<ResourceConcept R>
     void Resource::attach_resource(const std::string &unique_name, const Rc<R> &resource) {
-        if (attached_resources.contains(unique_name)) {
-            attached_resources[unique_name].detach_resource_user<R>(get_name());
-        }
+        ResourceAttachment &attachment = attached_resources[unique_name];
+        if (attachment.resource.get() != nullptr)
+            attachment.resource.detach_user(&attachment.user_position);
 
-        resource.attach_resource_user(std::type_index(typeid(*this)), get_name());
-        attached_resources[unique_name] = resource.template as<Resource>();
+        resource.attach_resource_user(type_id, this, &attachment.user_position);
+        attachment.resource = resource.template as<Resource>();
     }
 
     template<ResourceConcept R>
@@ -25,6 +23,6 @@ namespace wrld {
         if (!attached_resources.contains(unique_name)) {
             throw std::runtime_error(std::format("Tried to access unbound resource {}", unique_name));
         }
-        return attached_resources.at(unique_name).as<R>();
+        return attached_resources.at(unique_name).resource.as<R>();
     }
 } // namespace wrld
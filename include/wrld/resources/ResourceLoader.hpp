@@ -0,0 +1,103 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/ComponentStorage.hpp>
+#include <wrld/ThreadPool.hpp>
+#include <wrld/resources/Rc.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wrld {
+    class World;
+
+    /// Result of the decoding step of a load (see ResourceLoader::load).
+    struct ResourceUpload {
+        /// Called on the main thread with the loaded resource, to create its GPU objects.
+        std::function<void(Resource &)> upload;
+        /// Approximate amount of bytes sent to the GPU by upload, counted in the upload budget.
+        size_t bytes = 0;
+    };
+
+    /// Loads resources without blocking the main thread, in two steps:
+    /// - decoding (reading and parsing files), executed by worker threads dedicated to loading, so that long
+    ///   decodes never delay the systems nor run inside a parallel loop of the World,
+    /// - uploading (creating the GPU objects), executed by the main thread within a per-frame budget.
+    ///
+    /// The resource keeps its current content, usually the same as its default resource, until its upload.
+    /// Loading a resource cancels the previous load of the same resource, if it was not uploaded yet.
+    /// Loads may be started from any thread; the other functions must be called from the main thread.
+    class ResourceLoader {
+    public:
+        /// Amount of threads decoding resources. Decoding is mostly bound by the disk, and must not compete
+        /// with the systems for the cores.
+        static constexpr size_t DECODE_THREAD_COUNT = 2;
+
+        explicit ResourceLoader(World &world);
+
+        ResourceLoader(const ResourceLoader &other) = delete;
+        ResourceLoader &operator=(const ResourceLoader &other) = delete;
+
+        /// Execute decode on a worker thread, then the upload it returns on the main thread.
+        /// decode may throw, but must not use OpenGL or the resource, and may only use the parts of the World safe
+        /// to use from any thread (see World), as the main thread is using them.
+        /// Errors are reported when the upload would have occurred, and the resource is left unchanged.
+        void load(const Rc<Resource> &resource, std::function<ResourceUpload()> decode);
+
+        /// Execute the uploads of the decoded resources, in loading order, until the time or byte budget is
+        /// exceeded. At least one upload is executed if one is ready, so that a big resource is not stuck.
+        /// Return the amount of uploaded resources. Called each frame by Main.
+        size_t upload(std::chrono::microseconds time_budget, size_t byte_budget);
+
+        /// Wait for every pending load and upload it, regardless of any budget.
+        void finish();
+
+        /// Amount of loads not uploaded yet. Main thread only, like upload.
+        [[nodiscard]] size_t get_pending_count() const;
+
+        /// Return true if a resource was uploaded after the given tick.
+        [[nodiscard]] bool uploaded_since(Tick since) const;
+
+    private:
+        struct Load {
+            Rc<Resource> resource;
+            ResourceUpload result;
+            std::exception_ptr error;
+            // Set by the worker once result or error is written
+            std::atomic<bool> decoded = false;
+            // Set when a newer load of the same resource replaces this one
+            bool cancelled = false;
+        };
+
+        World &world;
+
+        // Pending loads, in loading order. Only accessed by the main thread, except for the decoding of each
+        // load, which workers write to. A load is only removed once decoded.
+        std::vector<std::unique_ptr<Load>> loads;
+
+        // Guards incoming
+        mutable std::mutex incoming_mutex;
+        // Loads started since the last drain, which may come from any thread
+        std::vector<std::unique_ptr<Load>> incoming;
+
+        Tick last_upload = 0;
+
+        // Declared last: joined before the loads the workers write to are destroyed
+        ThreadPool decode_pool;
+
+        /// Move the incoming loads to the pending ones, cancelling the older loads of the same resources.
+        void drain_incoming();
+
+        /// Upload the decoded load, or report its error.
+        void complete(Load &load);
+    };
+} // namespace wrld
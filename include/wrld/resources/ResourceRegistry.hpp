@@ -0,0 +1,115 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/StringInterner.hpp>
+#include <wrld/TypeId.hpp>
+#include <wrld/resources/Rc.hpp>
+#include <wrld/resources/ResourceStorage.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace wrld {
+    /// Maximum amount of resource types.
+    static constexpr size_t MAX_RESOURCE_TYPES = 64;
+
+    /// Named resources, indexed by the TypeId of their type.
+    typedef std::vector<std::unordered_map<NameID, Rc<Resource>>> ResourcePool;
+
+    /// Storages, names and default resources of the resources of a World. Safe to use from any thread.
+    ///
+    /// The registry is sharded by resource type: each type has its own lock, so that threads creating resources
+    /// of different types never wait for each other, and lookups only take it shared. The tables of every type
+    /// are allocated upfront, so that finding the shard of a type takes no lock. Default resources are read
+    /// without any lock once created.
+    class ResourceRegistry {
+    public:
+        ResourceRegistry();
+
+        ResourceRegistry(const ResourceRegistry &other) = delete;
+        ResourceRegistry &operator=(const ResourceRegistry &other) = delete;
+
+        ~ResourceRegistry();
+
+        /// Return the storage of the resource type.
+        /// Throws std::runtime_error if there are more than MAX_RESOURCE_TYPES resource types.
+        ResourceStorage &get_storage(TypeId type_id);
+
+        /// Intern a name not given to any resource of the type: the given name, or "{name}:{n}" if it is taken,
+        /// n increasing with each resource created with this name.
+        /// The name is taken until given to a resource by insert, or released by release_name.
+        NameID reserve_name(TypeId type_id, std::string_view name);
+
+        /// Give its reserved name to the resource.
+        void insert(TypeId type_id, NameID name, Rc<Resource> resource);
+
+        /// Release a name reserved for a resource which could not be created.
+        void release_name(TypeId type_id, NameID name);
+
+        /// Return the resource of the type with the given name, or an empty Rc.
+        [[nodiscard]] Rc<Resource> find(TypeId type_id, std::string_view name) const;
+
+        /// Remove the resource of the handle from the names of its type, if it still has its name.
+        /// The caller must keep a reference to the resource.
+        void remove(TypeId type_id, ResourceHandle handle);
+
+        /// Remove the resource of the slot from the names of its type if nothing else references it: no user, and
+        /// no Rc but its name and the reference the caller acquired (see ResourceStorage::acquire_at).
+        /// Return true if the name was removed: the resource is destroyed when the caller releases the slot.
+        bool remove_if_unused(ResourceSlot &slot);
+
+        /// Return the string of an interned name.
+        [[nodiscard]] std::string_view get_name(NameID name) const;
+
+        /// Return the default resource of the type, or an empty Rc if it was not created yet. Takes no lock.
+        [[nodiscard]] Rc<Resource> get_default(TypeId type_id) const;
+
+        /// Return the default resource of the type, creating it with create if required.
+        /// It is created once, even if several threads ask for it at the same time.
+        Rc<Resource> get_or_create_default(TypeId type_id, const std::function<Rc<Resource>()> &create);
+
+        /// Return a copy of the named resources of every type.
+        [[nodiscard]] ResourcePool get_resources() const;
+
+    private:
+        struct Shard {
+            // Guards names and name_suffixes
+            mutable std::shared_mutex mutex;
+            // Resources of the type, by name. Empty Rcs are reserved names of resources being created
+            std::unordered_map<NameID, Rc<Resource>> names;
+            // Last suffix given to each name by reserve_name
+            std::unordered_map<NameID, uint32_t> name_suffixes;
+
+            // Serializes the creation of the default resource, which is never changed once has_default is set
+            std::mutex default_mutex;
+            Rc<Resource> default_resource;
+            std::atomic<bool> has_default = false;
+        };
+
+        // Names of the resources, shared by every type
+        mutable std::shared_mutex name_strings_mutex;
+        StringInterner name_strings;
+
+        // Declared before the shards, which hold Rcs, so that the storages are destroyed last
+        std::array<std::unique_ptr<ResourceStorage>, MAX_RESOURCE_TYPES> storages;
+        std::array<Shard, MAX_RESOURCE_TYPES> shards;
+
+        /// Return the shard of the resource type (see get_storage).
+        [[nodiscard]] Shard &get_shard(TypeId type_id) const;
+
+        /// Intern the name, taking the lock only for new names.
+        NameID intern(std::string_view name);
+    };
+} // namespace wrld
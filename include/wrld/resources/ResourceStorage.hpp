@@ -0,0 +1,156 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/Entity.hpp>
+#include <wrld/StringInterner.hpp>
+#include <wrld/TypeId.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace wrld {
+    class Resource;
+    class ResourceStorage;
+
+    /// Compact, non-owning reference to a resource: slot index in the storage of its type, and generation
+    /// of the slot. Freed slots get a new generation, so a handle to a freed resource is detected as stale.
+    /// Unlike Rc, a handle does not keep the resource alive (see World::get_resource).
+    struct ResourceHandle {
+        static constexpr uint32_t NO_INDEX = std::numeric_limits<uint32_t>::max();
+
+        uint32_t index = NO_INDEX;
+        uint32_t generation = 0;
+
+        bool operator==(const ResourceHandle &other) const = default;
+    };
+
+    /// A component or a resource using a resource.
+    struct ResourceUser {
+        /// TypeId of the user, in the component or resource family.
+        TypeId type_id;
+        /// nullptr for component users.
+        const Resource *resource;
+        /// Entity of component users.
+        EntityID entity;
+        /// Where the user stores its position in the list, updated when it moves.
+        uint32_t *position;
+    };
+
+    /// Components and resources using a resource, in a dense list: registering or removing a user is O(1)
+    /// and allocates nothing once the list has grown. Each user keeps its position in the list (see
+    /// ResourceAttachment) to be removed without searching. Users attaching the resource several times
+    /// (under different names) appear several times.
+    /// Users may be added, removed and listed from any thread, as resources built by worker threads attach
+    /// other ones.
+    class ResourceUsers {
+    public:
+        /// Register a component user, storing its position in *position.
+        void add_component_user(TypeId type_id, EntityID entity, uint32_t *position);
+
+        /// Register a resource user, storing its position in *position.
+        void add_resource_user(TypeId type_id, const Resource *resource, uint32_t *position);
+
+        /// Remove the user whose position is stored in *position. The last user takes its place.
+        /// The position is read under the lock, as removing another user may move this one meanwhile.
+        void remove(const uint32_t *position);
+
+        /// Amount of component users.
+        [[nodiscard]] size_t get_component_user_count() const;
+
+        /// Amount of resource users.
+        [[nodiscard]] size_t get_resource_user_count() const;
+
+        /// Return a copy of the users, taken under the lock: the list may change while the copy is used.
+        [[nodiscard]] std::vector<ResourceUser> get_users() const;
+
+        [[nodiscard]] bool empty() const;
+
+    private:
+        mutable std::mutex mutex;
+        std::vector<ResourceUser> users;
+        size_t component_user_count = 0;
+    };
+
+    /// Slot of a ResourceStorage, holding one resource and its reference count.
+    /// Rc points directly to the slot: accessing the resource costs no lookup.
+    struct ResourceSlot {
+        std::unique_ptr<Resource> resource;
+        // TypeId of the resource, checked by Rc::as without RTTI
+        TypeId type_id = INVALID_TYPE_ID;
+        // Amount of Rc referencing the slot. The resource is destroyed when it drops to 0.
+        std::atomic<uint32_t> references = 0;
+        ResourceHandle handle;
+        ResourceStorage *storage = nullptr;
+        // Name of the resource in the pool of its World, or NO_NAME for default resources
+        NameID name = NO_NAME;
+
+        // Components and resources using the resource
+        ResourceUsers users;
+    };
+
+    /// Storage of every resource of a type, in slots addressed by ResourceHandle.
+    /// Slots are allocated in chunks and never move, so an Rc can point to its slot.
+    /// Slots of destroyed resources are reused, with a new generation.
+    ///
+    /// Slots are reference-counted by Rc: when the last Rc is destroyed, the resource is destroyed
+    /// and the slot freed. Releasing is thread-safe, as an Rc may be dropped on a worker thread.
+    class ResourceStorage {
+    public:
+        explicit ResourceStorage(TypeId type_id);
+
+        ~ResourceStorage();
+
+        ResourceStorage(const ResourceStorage &other) = delete;
+        ResourceStorage &operator=(const ResourceStorage &other) = delete;
+
+        /// Store the resource in a free slot, under the given name (NO_NAME for default resources).
+        /// The slot holds one reference, so that another thread acquiring it can not free it: adopt it in an Rc
+        /// right away (see Rc::adopt).
+        ResourceSlot &insert(std::unique_ptr<Resource> resource, NameID name);
+
+        /// Return the slot of the handle after taking a reference to it (see Rc::adopt),
+        /// or nullptr if the handle is stale.
+        [[nodiscard]] ResourceSlot *acquire(ResourceHandle handle);
+
+        /// Return the slot at the given index after taking a reference to it (see Rc::adopt),
+        /// or nullptr if the slot is free.
+        [[nodiscard]] ResourceSlot *acquire_at(size_t index);
+
+        /// Destroy the resource of the slot and free it, unless it was referenced again in the meantime.
+        /// Called by Rc when the reference count drops to 0.
+        void release(ResourceSlot &slot);
+
+        /// Amount of resources stored.
+        [[nodiscard]] size_t size() const;
+
+        /// TypeId of the stored resources.
+        [[nodiscard]] TypeId get_type_id() const;
+
+        /// Amount of slots allocated, used or free. Slot indices (see ResourceHandle) are below it.
+        [[nodiscard]] size_t get_slot_count() const;
+
+        /// Return the slot at the given index, which may be free (holding no resource).
+        [[nodiscard]] ResourceSlot &get_slot(size_t index);
+
+    private:
+        static constexpr size_t CHUNK_SIZE = 256;
+
+        TypeId type_id;
+
+        // Protects the slot table when resources are released from another thread
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<ResourceSlot[]>> chunks;
+        // Slots never used yet in the last chunk
+        size_t last_chunk_used = CHUNK_SIZE;
+        std::vector<ResourceSlot *> free_slots;
+        size_t used = 0;
+    };
+} // namespace wrld
@@ -8,17 +8,37 @@
 #include "assimp/material.h"
 
 
+#include <cstddef>
+#include <memory>
 #include <string>
 
 #include <glad/glad.h>
 
 namespace wrld::rsc {
+    /// Image decoded from a file (see Texture::decode), not sent to the GPU yet.
+    struct TextureImage {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        std::shared_ptr<unsigned char> pixels;
+
+        /// Size of the pixels, in bytes.
+        [[nodiscard]] size_t size() const;
+    };
+
     class Texture final : public Resource {
     public:
         explicit Texture(const std::string &name, World &world /*, Rc<Resource> *rc*/);
 
         Texture &set_texture(const std::string &texture_path, aiTextureType type, bool flip_textures = false);
 
+        /// Same as set_texture, but the file is decoded by a worker thread and the image uploaded during a later
+        /// frame (see ResourceLoader). The texture keeps its current image until then.
+        Texture &set_texture_async(const std::string &texture_path, aiTextureType type, bool flip_textures = false);
+
+        /// Decode the image file. Does not use OpenGL, so it can be called from any thread.
+        static TextureImage decode(const std::string &path, bool flip);
+
         Texture(Texture &other) = delete;
         Texture(Texture &&other) = delete;
         Texture &operator=(Texture &other) = delete;
@@ -26,10 +46,17 @@ namespace wrld::rsc {
 
         void use(unsigned unit = 0) const;
 
+        [[nodiscard]] const std::string &get_path() const;
+        [[nodiscard]] aiTextureType get_texture_type() const;
+        [[nodiscard]] bool is_flipped() const;
+
         ~Texture() override;
 
         std::string get_type() const override { return "Texture"; }
 
+        /// Load the texture file again, in the background (see set_texture_async).
+        void reload_async() override;
+
     private:
         GLuint gl_texture = 0;
         std::string path = "data/textures/default.png";
@@ -37,6 +64,14 @@ namespace wrld::rsc {
 
         void reload();
 
+        /// Send the image to the GPU, creating the texture if required. Only RGB and RGBA images are supported.
+        void upload(const TextureImage &image);
+
+        /// Delete the GL texture. It is decoded again from its file on its next use.
+        bool evict_gpu_memory() override;
+
+        void restore_gpu_memory() override;
+
         // Using Assimp enum for now, it's good enough
         aiTextureType type = aiTextureType_DIFFUSE;
     };
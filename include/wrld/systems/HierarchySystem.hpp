@@ -0,0 +1,57 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+#include <wrld/System.hpp>
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace wrld {
+    /// Propagates the model matrices of Transforms from parents to children (see cpt::Parent).
+    ///
+    /// The entities of the hierarchies are kept in a flat array, in breadth-first order: parents come
+    /// before their children and siblings are contiguous, so a single pass updates everything.
+    /// This order is only rebuilt when a Parent is added, changed or removed, an entity of the
+    /// hierarchy is deleted, or an entity left out for lack of a Transform (a child, or the parent
+    /// of an orphan) gets one. Only the subtrees whose Transform changed since the last run are updated.
+    class HierarchySystem final : public System {
+    public:
+        explicit HierarchySystem(World &world);
+
+        void exec() override;
+
+    private:
+        static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+        struct Node {
+            EntityID entity;
+            // Position of the parent in nodes, or NO_PARENT for roots
+            uint32_t parent;
+        };
+
+        // Entities having a Parent, and their ancestors, parents first
+        std::vector<Node> nodes;
+        // Model matrix of each node, parallel to nodes
+        std::vector<glm::mat4x4> model_matrices;
+        // Nodes to update on this run, parallel to nodes
+        std::vector<uint8_t> dirty;
+        // Entities left out of the hierarchy because they have no Transform: children, and parents of orphans
+        std::vector<EntityID> missing_transforms;
+
+        /// Recompute the order of the nodes from the Parent components.
+        void rebuild();
+
+        /// Returns true if an entity left out for lack of a Transform got one since the last rebuild.
+        [[nodiscard]] bool transform_added() const;
+
+        /// Update the dirty nodes and their descendants. Returns false if an entity of
+        /// the hierarchy lost its Transform or was deleted, in which case it must be rebuilt.
+        bool propagate();
+    };
+} // namespace wrld
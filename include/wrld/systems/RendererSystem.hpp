@@ -12,6 +12,13 @@
 #include <wrld/resources/Model.hpp>
 #include <wrld/resources/Program.hpp>
 
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
 namespace wrld {
     struct PointLightData {
         PointLightData(glm::vec3 position, glm::vec3 color, float intensity);
@@ -38,6 +45,99 @@ namespace wrld {
         std::optional<Rc<rsc::CubemapTexture> > skybox;
     };
 
+    /// A model to draw, with the matrices of its entity.
+    struct DrawItem {
+        const rsc::Model *model;
+        glm::mat4x4 model_matrix;
+        glm::mat4x4 normal_matrix;
+    };
+
+    /// Data kept for each entity of some kind, in a dense array, with O(1) insertion, lookup and removal.
+    /// Like ComponentStorage, entities are mapped to their position with a paged sparse array, without hashing.
+    template<typename T>
+    class EntityCache {
+    public:
+        /// Return the data of the entity, or nullptr.
+        T *find(const EntityID id) {
+            const uint32_t position = position_of(id);
+            return position == NONE ? nullptr : &items[position];
+        }
+
+        void insert(const EntityID id, const T &item) {
+            if (T *existing = find(id)) {
+                *existing = item;
+                return;
+            }
+
+            const EntityIndex index = entity_index(id);
+            const size_t page = index / PAGE_SIZE;
+            if (page >= sparse.size())
+                sparse.resize(page + 1);
+            if (!sparse[page]) {
+                sparse[page] = std::make_unique<SparsePage>();
+                sparse[page]->fill(NONE);
+            }
+
+            (*sparse[page])[index % PAGE_SIZE] = static_cast<uint32_t>(items.size());
+            entities.push_back(id);
+            items.push_back(item);
+        }
+
+        /// Swap-remove the data of the entity, if any.
+        void erase(const EntityID id) {
+            const uint32_t position = position_of(id);
+            if (position == NONE)
+                return;
+
+            const EntityIndex index = entity_index(id);
+            (*sparse[index / PAGE_SIZE])[index % PAGE_SIZE] = NONE;
+            if (position != items.size() - 1) {
+                items[position] = items.back();
+                entities[position] = entities.back();
+                const EntityIndex moved = entity_index(entities[position]);
+                (*sparse[moved / PAGE_SIZE])[moved % PAGE_SIZE] = position;
+            }
+            items.pop_back();
+            entities.pop_back();
+        }
+
+        [[nodiscard]] const std::vector<T> &get_items() const { return items; }
+
+        /// Items, to update them in place.
+        [[nodiscard]] std::span<T> get_items_mut() { return items; }
+
+        /// Entities of the items, at the same positions.
+        [[nodiscard]] const std::vector<EntityID> &get_entities() const { return entities; }
+
+    private:
+        static constexpr size_t PAGE_SIZE = 4096;
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        typedef std::array<uint32_t, PAGE_SIZE> SparsePage;
+
+        std::vector<EntityID> entities;
+        std::vector<T> items;
+        // Entity index -> position in the dense arrays
+        std::vector<std::unique_ptr<SparsePage>> sparse;
+
+        /// Return the position of the entity, or NONE.
+        [[nodiscard]] uint32_t position_of(const EntityID id) const {
+            const EntityIndex index = entity_index(id);
+            const size_t page = index / PAGE_SIZE;
+            if (page >= sparse.size() || !sparse[page])
+                return NONE;
+
+            // The slot may be used by another generation of the entity
+            const uint32_t position = (*sparse[page])[index % PAGE_SIZE];
+            return position == NONE || entities[position] != id ? NONE : position;
+        }
+    };
+
+    /// Renders the world from the first camera found.
+    /// Models and lights are cached, and kept up to date with World observers: the renderer does not
+    /// look them up each frame, and a static scene is not processed again. Transforms are not observed, as
+    /// they change often and from any thread: the cached ones are refreshed in exec, when changed since the
+    /// last run.
     class RendererSystem : public System {
     public:
         static constexpr unsigned MAX_LIGHTS = 100;
@@ -56,17 +156,45 @@ namespace wrld {
     protected:
         GLFWwindow *window;
 
+        // Every camera of the world, the first one being rendered
+        Query<cpt::Camera3D> &cameras;
+
         Rc<rsc::Program> skybox_program;
 
         /// Amount of visible models on the active camera.
         unsigned visible_models = 0;
 
+        // Every entity having a StaticModel, and every light, maintained by observers
+        EntityCache<DrawItem> renderables;
+        EntityCache<PointLightData> point_lights;
+        EntityCache<DirectionalLightData> directional_lights;
+        // Set when a renderable was added, removed or changed since the draw list was built
+        bool renderables_changed = true;
+
+        std::vector<ObserverID> observers;
+
+        /// Models visible by the active camera. Kept from a frame to the next, and only rebuilt
+        /// when the camera moved or a renderable was added, changed or removed.
+        std::vector<DrawItem> draw_list;
+        glm::mat4x4 draw_list_view_projection{0};
+        bool draw_list_culling = false;
+
+        /// Rebuild draw_list if required, and update visible_models.
+        void update_draw_list(const cpt::Camera3D &camera, const glm::mat4x4 &view_projection);
+
+        /// Register the observers maintaining the caches, and fill them with the current entities.
+        void observe_world();
+
+        /// Update the cached transforms of the renderables and lights whose Transform was added or changed since
+        /// the last run.
+        void refresh_transforms();
+
         /// Return the entity's transform or a default one if not provided.
         [[nodiscard]] glm::mat4x4 get_entity_transform(EntityID id) const;
 
         /// Return the active camera component (for now, the first CameraComponent found).
         /// Returns std::nullopt if there is none.
-        [[nodiscard]] std::optional<std::shared_ptr<const cpt::Camera3D> > get_camera() const;
+        [[nodiscard]] std::optional<ComponentRef<const cpt::Camera3D> > get_camera() const;
 
         /// Return the model of an entity. Fails if the entity has no StaticModel
         /// component.
@@ -78,17 +206,16 @@ namespace wrld {
         [[nodiscard]] EnvironmentData get_environment(const cpt::Camera3D &camera) const;
 
         /// Return data of all PointLights in the world.
-        /// Won't return more than MAX_LIGHTS. The vector is resized before
-        /// being returned.
-        [[nodiscard]] std::vector<PointLightData> get_point_lights() const;
+        /// Won't return more than MAX_LIGHTS.
+        [[nodiscard]] std::span<const PointLightData> get_point_lights() const;
 
         /// Return data of all DirectionalLights in the world.
-        /// Won't return more than MAX_LIGHTS. The vector is resized before
-        /// being returned.
-        [[nodiscard]] std::vector<DirectionalLightData> get_directional_lights() const;
+        /// Won't return more than MAX_LIGHTS.
+        [[nodiscard]] std::span<const DirectionalLightData> get_directional_lights() const;
 
         void draw_skybox(const rsc::CubemapTexture &cubemap, const cpt::Camera3D &camera, GLuint vao) const;
 
-        static void draw_model(const rsc::Model &model, const glm::mat4x4 &model_matrix, const rsc::Program &program);
+        void draw_model(const rsc::Model &model, const glm::mat4x4 &model_matrix, const glm::mat4x4 &normal_matrix,
+                        const rsc::Program &program) const;
     };
 } // namespace wrld
@@ -0,0 +1,10 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#pragma once
+
+namespace wrld::tag {
+    /// Entities tagged Hidden are not rendered.
+    struct Hidden {};
+} // namespace wrld::tag
@@ -16,6 +16,11 @@ namespace wrld::tools {
         /// Test if the bounding-box of the entity-attached model (or TODO: modelgroup)
         /// is in the frustum of camera.
         static bool is_visible(World &world, EntityID entity, EntityID camera);
+
+        /// Test if the local bounding-box of model, placed with model_matrix, is in the frustum
+        /// described by view_projection (projection * view matrix of the camera).
+        static bool is_visible(const rsc::Model &model, const glm::mat4x4 &model_matrix,
+                               const glm::mat4x4 &view_projection);
     };
 
 } // namespace wrld::tools
@@ -4,10 +4,12 @@
 
 #include <wrld/App.hpp>
 #include <wrld/Main.hpp>
+#include <wrld/Snapshot.hpp>
 
 #include <wrld/components/Camera3D.hpp>
 #include <wrld/components/DirectionalLight.hpp>
 #include <wrld/components/FPSControl.hpp>
+#include <wrld/components/PointLight.hpp>
 #include <wrld/components/StaticModel.hpp>
 #include <wrld/components/Transform.hpp>
 #include <wrld/resources/Model.hpp>
@@ -17,6 +19,7 @@
 
 #include "assimp/postprocess.h"
 
+#include <filesystem>
 #include <iostream>
 #include <wrld/logs.hpp>
 #include <wrld/tools/ModelTool.hpp>
@@ -30,39 +33,21 @@ public:
     ~ProIma() override = default;
 
     void init(World &world) override {
-        // Load a material to be shared by every mesh.
-        // In rungholt.obj, each mesh represent a block type, and each has a specific material
-        // If we let the Model importer do its job, we'll have too much materials (not worth it for now).
-        // We create a custom basic material with the texture attached to it, it will work just fine but
-        // we'll have only 1 material meaning 1 draw call needed
-        const auto texture = world.create_resource<rsc::Texture>("minecraft_texture");
-        texture.get_mut()->set_texture("data/models/rungholt/house-RGBA.png", aiTextureType_DIFFUSE, false);
-
-        const auto material = world.create_resource<rsc::Material>("city_material");
-        material.get_mut()->set_diffuse_map(texture);
-        material.get_mut()->set_specular_intensity(0.9);
-        material.get_mut()->set_shininess(64);
-
-        auto city_model = world.create_resource<rsc::Model>("city_model");
-        city_model.get_mut()->from_file("data/models/rungholt/rungholt.obj", aiProcess_Triangulate | aiProcess_FlipUVs,
-                                        false, material);
-
-        wrldInfo("Splitting model");
-        const auto &split_models = tools::ModelTool::split_in_grid(world, city_model, 30);
-        world.destroy_resource<rsc::Model>(city_model);
-
-        // Create an entity for each split models
-        for (const auto &s: split_models) {
-            const EntityID city_crumb = world.create_entity("city_crumb");
-            world.attach_component<cpt::StaticModel>(city_crumb, s);
+        // Importing and splitting the city takes a while: the result is saved in a snapshot,
+        // loaded instead on the next starts. Delete the file to rebuild the scene.
+        if (!load_snapshot(world)) {
+            build_scene(world);
+            Snapshot::save(world, SNAPSHOT_PATH);
         }
 
+        // The lights may come from the snapshot: find them back
+        size_t light_count = 0;
+        for (const auto &[entity, light, transform]: world.view<cpt::PointLight, cpt::Transform>()) {
+            if (light_count < LIGHT_COUNT)
+                light_transforms[light_count++] = ComponentRef(&transform);
+        }
 
-        // city_model.get_mut()->from_file("data/models/rungholt/house.obj", aiProcess_Triangulate | aiProcess_FlipUVs,
-        //                                 false, material);
-
-        // const EntityID city_entity = world.create_entity("City");
-
+        // The camera is not saved in the snapshot
         const EntityID camera_entity = world.create_entity("Camera");
         world.attach_component<cpt::Camera3D>(camera_entity, 45, true, Main::get_window_viewport(),
                                             world.get_default<rsc::Program>());
@@ -73,20 +58,6 @@ public:
         env->set_ambiant_light(cpt::AmbiantLight{glm::vec3{1.0, 0.83, 0.64}, 0.4});
         env->set_cubemap(world.get_default<rsc::CubemapTexture>());
 
-        const EntityID sun = world.create_entity("Sun");
-        world.attach_component<cpt::DirectionalLight>(sun, glm::vec3{1, 0.69, 0.35}, 0.4);
-        world.attach_component<cpt::Transform>(sun);
-
-        for (int i = 0; i < LIGHT_COUNT; i++) {
-            const EntityID light = world.create_entity(std::format("Light_{}", i));
-            world.attach_component<cpt::PointLight>(
-                light, glm::vec3{(rand() % 255) / 255.0, (rand() % 255) / 255.0, (rand() % 255) / 255.0}, 10.0);
-            const auto &transform = world.attach_component<cpt::Transform>(light);
-            transform->set_position(
-                glm::vec3{300.0 - float(rand() % 600), float(rand() % 50), 300.0 - float(rand() % 600)});
-            light_transforms[i] = transform;
-        }
-
         glfwSetInputMode(Main::get_window(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
 
@@ -133,13 +104,80 @@ public:
     }
 
 private:
+    static constexpr auto SNAPSHOT_PATH = "proima.snapshot";
+
+    /// Restore the scene from the snapshot. Return false if there is none, or if it could not be loaded
+    /// (written by another version, corrupted...), in which case it is deleted and the world left untouched.
+    static bool load_snapshot(World &world) {
+        if (!std::filesystem::exists(SNAPSHOT_PATH))
+            return false;
+
+        try {
+            Snapshot::load(world, SNAPSHOT_PATH);
+            return true;
+        } catch (const std::exception &e) {
+            wrldError(std::format("Unable to load {}, rebuilding the scene: {}", SNAPSHOT_PATH, e.what()));
+            std::error_code error;
+            std::filesystem::remove(SNAPSHOT_PATH, error);
+            return false;
+        }
+    }
+
+    /// Import the city, split it and create the lights.
+    static void build_scene(World &world) {
+        // Load a material to be shared by every mesh.
+        // In rungholt.obj, each mesh represent a block type, and each has a specific material
+        // If we let the Model importer do its job, we'll have too much materials (not worth it for now).
+        // We create a custom basic material with the texture attached to it, it will work just fine but
+        // we'll have only 1 material meaning 1 draw call needed
+        const auto texture = world.create_resource<rsc::Texture>("minecraft_texture");
+        texture.get_mut()->set_texture_async("data/models/rungholt/house-RGBA.png", aiTextureType_DIFFUSE, false);
+
+        const auto material = world.create_resource<rsc::Material>("city_material");
+        material.get_mut()->set_diffuse_map(texture);
+        material.get_mut()->set_specular_intensity(0.9);
+        material.get_mut()->set_shininess(64);
+
+        auto city_model = world.create_resource<rsc::Model>("city_model");
+        city_model.get_mut()->from_file("data/models/rungholt/rungholt.obj", aiProcess_Triangulate | aiProcess_FlipUVs,
+                                        false, material);
+
+        wrldInfo("Splitting model");
+        const auto &split_models = tools::ModelTool::split_in_grid(world, city_model, 30);
+        world.destroy_resource<rsc::Model>(city_model);
+
+        // Create an entity for each split models
+        const auto city_crumbs = world.create_entities(split_models.size(), "city_crumb");
+        world.attach_components_from<cpt::StaticModel>(
+                city_crumbs, [&split_models](const size_t i) { return std::tuple{split_models[i]}; });
+
+
+        // city_model.get_mut()->from_file("data/models/rungholt/house.obj", aiProcess_Triangulate | aiProcess_FlipUVs,
+        //                                 false, material);
+
+        // const EntityID city_entity = world.create_entity("City");
+
+        const EntityID sun = world.create_entity("Sun");
+        world.attach_component<cpt::DirectionalLight>(sun, glm::vec3{1, 0.69, 0.35}, 0.4);
+        world.attach_component<cpt::Transform>(sun);
+
+        for (int i = 0; i < LIGHT_COUNT; i++) {
+            const EntityID light = world.create_entity(std::format("Light_{}", i));
+            world.attach_component<cpt::PointLight>(
+                light, glm::vec3{(rand() % 255) / 255.0, (rand() % 255) / 255.0, (rand() % 255) / 255.0}, 10.0);
+            const auto &transform = world.attach_component<cpt::Transform>(light);
+            transform->set_position(
+                glm::vec3{300.0 - float(rand() % 600), float(rand() % 50), 300.0 - float(rand() % 600)});
+        }
+    }
+
     // static constexpr int LIGHT_COUNT = 100;
     static constexpr int LIGHT_COUNT = 1;
 
     // Rc<rsc::Model> city_model;
-    std::shared_ptr<cpt::FPSControl> control;
+    ComponentRef<cpt::FPSControl> control;
 
-    std::array<std::shared_ptr<cpt::Transform>, LIGHT_COUNT> light_transforms;
+    std::array<ComponentRef<cpt::Transform>, LIGHT_COUNT> light_transforms;
 
     bool capture_cursor = true;
     bool l_key_pressed = false;
@@ -22,6 +22,7 @@
 #include "imgui.h"
 #include "assimp/postprocess.h"
 
+#include <filesystem>
 #include <iostream>
 
 using namespace wrld;
@@ -33,8 +34,18 @@ public:
     ~BlobApp() override {}
 
     void init(World &world) override {
+        // Edited shaders are reloaded on save
+        world.get_file_watcher().set_enabled(true);
+
+        // Like the models in data/, the shader sources are found from the repository root. Elsewhere, the
+        // embedded copies are used, and cannot be edited
         shader = world.create_resource<rsc::Program>("shader");
-        shader.get_mut()->from_source(shader::DEFAULT_VERTEX, shader::DEFAULT_FRAGMENT);
+        if (std::filesystem::exists(VERTEX_SHADER_PATH) && std::filesystem::exists(FRAGMENT_SHADER_PATH)) {
+            shader.get_mut()->from_file(VERTEX_SHADER_PATH, FRAGMENT_SHADER_PATH);
+        } else {
+            wrldInfo(std::format("{} not found, using the embedded shaders", VERTEX_SHADER_PATH));
+            shader.get_mut()->from_source(shader::DEFAULT_VERTEX, shader::DEFAULT_FRAGMENT);
+        }
 
         model = world.create_resource<rsc::Model>("user_model");
         model.get_mut()->from_file(model_path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals, false);
@@ -69,7 +80,7 @@ public:
         {
             if (glfwGetKey(Main::get_window(), GLFW_KEY_R) == GLFW_PRESS && !shade_reloading) {
                 shade_reloading = true;
-                camera->get_program().get_mut()->reload();
+                camera->get_program().get_mut()->reload_async();
             }
             if (glfwGetKey(Main::get_window(), GLFW_KEY_R) == GLFW_RELEASE) {
                 shade_reloading = false;
@@ -133,6 +144,9 @@ public:
     void exit(World &world) override { std::cout << "Goodbye!" << std::endl; }
 
 private:
+    static constexpr auto VERTEX_SHADER_PATH = "src/wrld/shaders/vertex/default.glsl";
+    static constexpr auto FRAGMENT_SHADER_PATH = "src/wrld/shaders/fragment/default.glsl";
+
     // Input from user
     std::string model_path;
 
@@ -140,9 +154,9 @@ private:
     Rc<rsc::Model> model;
     Rc<rsc::Program> shader;
 
-    std::shared_ptr<cpt::Transform> model_transform;
-    std::shared_ptr<cpt::Camera3D> camera;
-    std::shared_ptr<cpt::Orbiter> orbiter;
+    ComponentRef<cpt::Transform> model_transform;
+    ComponentRef<cpt::Camera3D> camera;
+    ComponentRef<cpt::Orbiter> orbiter;
 
     // Runtime variables
     bool shade_reloading = false;
@@ -7,10 +7,23 @@
 namespace wrld::gui {
     void render_component_window(World &world, bool *p_open) {
         ImGui::Begin("Scene", p_open);
-        for (const auto &[ent_id, ent_name]: world.get_entities()) {
-            if (ImGui::TreeNode(std::format("{}##{}", ent_name, ent_id).c_str())) {
+        for (const EntityID ent_id: world.get_entities()) {
+            // Nothing is formatted nor copied for closed nodes
+            const std::string_view ent_name = world.get_name(ent_id);
+            const bool open = ent_name.empty()
+                                      ? ImGui::TreeNode(reinterpret_cast<void *>(ent_id), "#%u", entity_index(ent_id))
+                                      : ImGui::TreeNode(reinterpret_cast<void *>(ent_id), "%.*s",
+                                                        static_cast<int>(ent_name.size()), ent_name.data());
+            if (open) {
                 ImGui::Text("%s", std::format("Entity ID: {}", ent_id).c_str());
 
+                if (bool hidden = world.has_tag<tag::Hidden>(ent_id); ImGui::Checkbox("Hidden", &hidden)) {
+                    if (hidden)
+                        world.add_tag<tag::Hidden>(ent_id);
+                    else
+                        world.remove_tag<tag::Hidden>(ent_id);
+                }
+
                 auto component_types = world.get_components_of_entity(ent_id);
                 for (const auto &type: component_types) {
                     // Retrieve the appropriate function from the map and call it
@@ -0,0 +1,73 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#include <wrld/CommandBuffer.hpp>
+#include <wrld/World.hpp>
+#include <wrld/logs.hpp>
+
+#include <format>
+#include <iostream>
+
+namespace wrld {
+    CommandBuffer::CommandBuffer(World &world) : world(world) {}
+
+    EntityID CommandBuffer::create_entity(const std::string &name) {
+        const std::lock_guard lock(mutex);
+
+        // The World tables are only grown by flush, on the main thread
+        const EntityID id = world.reserve_entity_deferred();
+        commands.push_back(Command{0, id, [&world = world, id, name] { world.activate_entity(id, name); }, nullptr});
+        return id;
+    }
+
+    void CommandBuffer::delete_entity(const EntityID id) {
+        push(Command{0, id, [&world = world, id] { world.delete_entity(id); }, nullptr});
+    }
+
+    bool CommandBuffer::empty() const {
+        const std::lock_guard lock(mutex);
+        return commands.empty();
+    }
+
+    void CommandBuffer::flush() {
+        // Take the commands out, so that commands recorded while applying go to the next flush
+        std::vector<Command> pending;
+        {
+            const std::lock_guard lock(mutex);
+            pending.swap(commands);
+        }
+
+        world.grow_reserved_entities();
+
+        // Grow each component storage once for all its attachments
+        std::vector<std::pair<void (*)(World &, size_t), size_t>> reserves;
+        for (const Command &command: pending) {
+            if (command.reserve == nullptr)
+                continue;
+            if (command.type_id >= reserves.size())
+                reserves.resize(command.type_id + 1);
+            reserves[command.type_id].first = command.reserve;
+            reserves[command.type_id].second += 1;
+        }
+        for (const auto &[reserve, count]: reserves) {
+            if (reserve != nullptr)
+                reserve(world, count);
+        }
+
+        // Applied in recording order: reordering would change the meaning of a detach followed by an attach
+        for (Command &command: pending) {
+            try {
+                command.apply();
+            } catch (const std::exception &e) {
+                // The other commands are still applied
+                wrldError(std::format("Unable to apply a command to entity {}: {}", command.entity, e.what()));
+            }
+        }
+    }
+
+    void CommandBuffer::push(Command command) {
+        const std::lock_guard lock(mutex);
+        commands.push_back(std::move(command));
+    }
+} // namespace wrld
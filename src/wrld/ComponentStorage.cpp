@@ -0,0 +1,105 @@
+//
+// Created by leo on 10/17/25.
+//
+
+#include <wrld/ComponentStorage.hpp>
+
+#include <cassert>
+
+namespace wrld {
+    ComponentStorageBase::ComponentStorageBase(const std::type_index type, const std::atomic<Tick> &clock) :
+        type(type), clock(clock) {}
+
+    bool ComponentStorageBase::contains(const EntityID id) const { return dense_index(id) != NONE; }
+
+    size_t ComponentStorageBase::size() const { return dense.size(); }
+
+    const std::vector<EntityID> &ComponentStorageBase::get_entities() const { return dense; }
+
+    std::type_index ComponentStorageBase::get_type() const { return type; }
+
+    void ComponentStorageBase::mark_changed(const EntityID id) {
+        const size_t position = dense_index(id);
+        if (position == NONE)
+            return;
+
+        const Tick now = clock.load(std::memory_order_relaxed);
+        changed_ticks[position] = now;
+        last_change.store(now, std::memory_order_relaxed);
+    }
+
+    bool ComponentStorageBase::added_since(const EntityID id, const Tick since) const {
+        const size_t position = dense_index(id);
+        return position != NONE && added_ticks[position] > since;
+    }
+
+    bool ComponentStorageBase::changed_since(const EntityID id, const Tick since) const {
+        const size_t position = dense_index(id);
+        return position != NONE && changed_ticks[position] > since;
+    }
+
+    Tick ComponentStorageBase::get_last_change() const { return last_change.load(std::memory_order_relaxed); }
+
+    size_t ComponentStorageBase::dense_index(const EntityID id) const {
+        const EntityIndex index = entity_index(id);
+        const size_t page = index / PAGE_SIZE;
+        if (page >= sparse.size() || !sparse[page])
+            return NONE;
+
+        // The slot may be used by another generation of the entity
+        const uint32_t position = (*sparse[page])[index % PAGE_SIZE];
+        if (position == NONE || dense[position] != id)
+            return NONE;
+        return position;
+    }
+
+    uint32_t &ComponentStorageBase::sparse_slot(const EntityIndex index) {
+        return (*sparse[index / PAGE_SIZE])[index % PAGE_SIZE];
+    }
+
+    void ComponentStorageBase::reserve_entities(const size_t capacity) {
+        dense.reserve(capacity);
+        added_ticks.reserve(capacity);
+        changed_ticks.reserve(capacity);
+    }
+
+    size_t ComponentStorageBase::push_entity(const EntityID id) {
+        const EntityIndex index = entity_index(id);
+        const size_t page = index / PAGE_SIZE;
+        if (page >= sparse.size())
+            sparse.resize(page + 1);
+        if (!sparse[page]) {
+            sparse[page] = std::make_unique<SparsePage>();
+            sparse[page]->fill(NONE);
+        }
+
+        assert(sparse_slot(index) == NONE);
+
+        sparse_slot(index) = static_cast<uint32_t>(dense.size());
+        const Tick now = clock.load(std::memory_order_relaxed);
+        dense.push_back(id);
+        added_ticks.push_back(now);
+        changed_ticks.push_back(now);
+        last_change.store(now, std::memory_order_relaxed);
+        return dense.size() - 1;
+    }
+
+    size_t ComponentStorageBase::pop_entity(const EntityID id) {
+        const size_t position = dense_index(id);
+        assert(position != NONE);
+
+        // Move the last entity in the hole, then shrink
+        const EntityID last = dense.back();
+        dense[position] = last;
+        added_ticks[position] = added_ticks.back();
+        changed_ticks[position] = changed_ticks.back();
+        sparse_slot(entity_index(last)) = static_cast<uint32_t>(position);
+        sparse_slot(entity_index(id)) = NONE;
+        dense.pop_back();
+        added_ticks.pop_back();
+        changed_ticks.pop_back();
+        last_change.store(clock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        return position;
+    }
+} // namespace wrld
@@ -10,34 +10,39 @@
 
 #include <wrld/logs.hpp>
 #include <wrld/systems/DeferredRendererSystem.hpp>
+#include <wrld/systems/HierarchySystem.hpp>
 #include <wrld/systems/RendererSystem.hpp>
 
 #include <utility>
 
 namespace wrld {
     // Default Main values
-    World Main::world;
+    std::unique_ptr<World> Main::world = nullptr;
     GLFWwindow *Main::window = nullptr;
     std::shared_ptr<rsc::WindowFramebuffer> Main::window_viewport = nullptr;
     bool Main::should_close = false;
     double Main::last_frame = 0;
     RendererType Main::renderer_type = FORWARD_RENDERER;
+    std::chrono::microseconds Main::resource_collection_budget = std::chrono::microseconds(500);
+    std::chrono::microseconds Main::upload_time_budget = std::chrono::milliseconds(4);
+    size_t Main::upload_byte_budget = 64 * 1024 * 1024;
 
     void Main::run(App &app, const unsigned width, const unsigned height) {
         window = init_gl(width, height);
         window_viewport = std::make_shared<rsc::WindowFramebuffer>(window);
         glfwSetWindowSizeCallback(window, window_resize_callback);
 
-        world = World();
+        world = std::make_unique<World>();
 
         // Create systems
         wrldInfo("Initialising systems");
-        // RendererSystem renderer{world, window};
-        std::unique_ptr<RendererSystem> renderer = get_renderer();
+        // The hierarchy is added first: systems accessing the same components run in insertion order
+        world->get_scheduler().add_system<HierarchySystem>();
+        world->get_scheduler().add_system(get_renderer());
 
         should_close = false;
         wrldInfo("Initializing app");
-        app.init(world);
+        app.init(*world);
 
         wrldInfo("Starting main loop");
         while (!should_close) {
@@ -52,10 +57,24 @@ namespace wrld {
             last_frame = current_frame;
 
             // Update user application
-            app.update(world, deltatime);
+            app.update(*world, deltatime);
+            world->flush_commands();
+
+            // Reload the resources whose files changed, then upload the ones loaded in the background,
+            // a few at a time
+            world->get_file_watcher().poll();
+            world->get_loader().upload(upload_time_budget, upload_byte_budget);
 
             // Execute systems
-            renderer->exec();
+            world->get_scheduler().run();
+            world->flush_commands();
+
+            // Free resources which are not used anymore, a few at a time
+            if (resource_collection_budget.count() > 0)
+                world->collect_unused_resources(resource_collection_budget);
+
+            // Free the GPU memory of the resources not drawn for a while, if over budget
+            world->get_gpu_memory().evict();
 
             // Render UI using ImGUI
             {
@@ -63,7 +82,7 @@ namespace wrld {
                 ImGui_ImplGlfw_NewFrame();
                 ImGui::NewFrame();
 
-                app.ui(world);
+                app.ui(*world);
 
                 ImGui::Render();
                 ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -79,7 +98,7 @@ namespace wrld {
         }
 
         wrldInfo("Exiting app");
-        app.exit(world);
+        app.exit(*world);
     }
 
     void Main::exit() { should_close = true; }
@@ -90,14 +109,23 @@ namespace wrld {
 
     void Main::set_renderer_type(const RendererType _renderer_type) { renderer_type = _renderer_type; }
 
+    void Main::set_resource_collection_budget(const std::chrono::microseconds budget) {
+        resource_collection_budget = budget;
+    }
+
+    void Main::set_upload_budget(const std::chrono::microseconds time_budget, const size_t byte_budget) {
+        upload_time_budget = time_budget;
+        upload_byte_budget = byte_budget;
+    }
+
     std::unique_ptr<RendererSystem> Main::get_renderer() {
         switch (renderer_type) {
             case FORWARD_RENDERER:
                 wrldInfo("Using forward renderer");
-                return std::make_unique<RendererSystem>(world, window);
+                return std::make_unique<RendererSystem>(*world, window);
             case DEFERRED_RENDERER:
                 wrldInfo("Using deferred renderer");
-                return std::make_unique<DeferredRendererSystem>(world, window);
+                return std::make_unique<DeferredRendererSystem>(*world, window);
             default:
                 std::unreachable();
         }
@@ -0,0 +1,38 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/Query.hpp>
+
+namespace wrld {
+    QueryBase::QueryBase(const ComponentSignature required) : required(required) {}
+
+    const std::vector<EntityID> &QueryBase::get_entities() const { return entities; }
+
+    size_t QueryBase::size() const { return entities.size(); }
+
+    bool QueryBase::empty() const { return entities.empty(); }
+
+    const ComponentSignature &QueryBase::get_required() const { return required; }
+
+    void QueryBase::update(const EntityID id, const ComponentSignature &signature) {
+        const EntityIndex index = entity_index(id);
+        const bool matches = (signature & required) == required;
+        const bool contained = index < positions.size() && positions[index] != NO_POSITION;
+
+        if (matches && !contained) {
+            if (index >= positions.size())
+                positions.resize(index + 1, NO_POSITION);
+            positions[index] = static_cast<uint32_t>(entities.size());
+            entities.push_back(id);
+        } else if (!matches && contained) {
+            // Swap-remove
+            const uint32_t position = positions[index];
+            const EntityID last = entities.back();
+            entities[position] = last;
+            positions[entity_index(last)] = position;
+            entities.pop_back();
+            positions[index] = NO_POSITION;
+        }
+    }
+} // namespace wrld
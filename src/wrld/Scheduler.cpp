@@ -0,0 +1,108 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/Scheduler.hpp>
+#include <wrld/System.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace wrld {
+    Scheduler::Scheduler(World &world, ThreadPool &thread_pool) : world(world), thread_pool(thread_pool) {}
+
+    Scheduler::~Scheduler() = default;
+
+    System &Scheduler::add_system(std::unique_ptr<System> system) {
+        graph_outdated = true;
+        return *systems.emplace_back(std::move(system));
+    }
+
+    void Scheduler::run() {
+        if (systems.empty())
+            return;
+        if (graph_outdated)
+            build_graph();
+
+        // Shared state of this frame, protected by mutex
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<size_t> remaining = dependency_counts;
+        std::vector<size_t> main_thread_ready;
+        size_t finished = 0;
+        std::exception_ptr error;
+
+        // Called with the lock held, when every dependency of the system finished
+        std::function<void(size_t)> start;
+
+        const auto execute = [&](const size_t i) {
+            try {
+                systems[i]->run();
+            } catch (...) {
+                const std::lock_guard lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+
+            const std::lock_guard lock(mutex);
+            finished += 1;
+            for (const size_t dependent: dependents[i]) {
+                remaining[dependent] -= 1;
+                if (remaining[dependent] == 0)
+                    start(dependent);
+            }
+            condition.notify_all();
+        };
+
+        start = [&](const size_t i) {
+            if (systems[i]->get_access().main_thread)
+                main_thread_ready.push_back(i);
+            else
+                thread_pool.submit([&execute, i] { execute(i); });
+        };
+
+        std::unique_lock lock(mutex);
+        for (size_t i = 0; i < systems.size(); i++) {
+            if (remaining[i] == 0)
+                start(i);
+        }
+
+        // Run the main thread systems here, until every system finished
+        while (finished < systems.size()) {
+            if (!main_thread_ready.empty()) {
+                const size_t i = main_thread_ready.back();
+                main_thread_ready.pop_back();
+
+                lock.unlock();
+                execute(i);
+                lock.lock();
+            } else {
+                condition.wait(lock);
+            }
+        }
+        lock.unlock();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    const std::vector<std::unique_ptr<System>> &Scheduler::get_systems() const { return systems; }
+
+    void Scheduler::build_graph() {
+        dependents.assign(systems.size(), {});
+        dependency_counts.assign(systems.size(), 0);
+
+        // A system waits for every conflicting system added before it
+        for (size_t i = 0; i < systems.size(); i++) {
+            for (size_t j = i + 1; j < systems.size(); j++) {
+                if (systems[i]->get_access().conflicts_with(systems[j]->get_access())) {
+                    dependents[i].push_back(j);
+                    dependency_counts[j] += 1;
+                }
+            }
+        }
+
+        graph_outdated = false;
+    }
+} // namespace wrld
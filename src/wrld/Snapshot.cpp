@@ -0,0 +1,822 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/Snapshot.hpp>
+#include <wrld/World.hpp>
+#include <wrld/components/DirectionalLight.hpp>
+#include <wrld/components/Parent.hpp>
+#include <wrld/components/PointLight.hpp>
+#include <wrld/components/StaticModel.hpp>
+#include <wrld/components/Transform.hpp>
+#include <wrld/logs.hpp>
+#include <wrld/resources/Material.hpp>
+#include <wrld/resources/Model.hpp>
+#include <wrld/resources/Texture.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace wrld {
+    namespace {
+        // Sections are read in file order: resources are written before what references them.
+        // Unknown sections are skipped, so new ones can be added without breaking older readers.
+        enum SectionKind : uint32_t {
+            TEXTURES_SECTION = 1,
+            MATERIALS_SECTION = 2,
+            MODELS_SECTION = 3,
+            ENTITIES_SECTION = 4,
+            TRANSFORMS_SECTION = 5,
+            STATIC_MODELS_SECTION = 6,
+            POINT_LIGHTS_SECTION = 7,
+            DIRECTIONAL_LIGHTS_SECTION = 8,
+            PARENTS_SECTION = 9,
+        };
+
+        // Arrays are aligned on this boundary, relative to the start of the file (mapped on a page boundary)
+        constexpr size_t ALIGNMENT = 16;
+
+        // Resource references are indices in the table of their section, or one of these
+        constexpr uint32_t NO_RESOURCE = std::numeric_limits<uint32_t>::max();
+        constexpr uint32_t DEFAULT_RESOURCE = NO_RESOURCE - 1;
+
+        struct Header {
+            uint32_t magic;
+            uint32_t version;
+            // Guards against reading a snapshot written with another layout of the stored types
+            uint32_t vertex_size;
+            uint32_t entity_id_size;
+        };
+
+        struct SectionHeader {
+            uint32_t kind;
+            uint32_t padding;
+            // Size of the section content, following this header
+            uint64_t size;
+        };
+
+        struct MaterialRecord {
+            glm::vec4 diffuse_color;
+            float specular_intensity;
+            float shininess;
+            uint32_t diffuse_map;
+            uint32_t specular_map;
+            uint32_t primitive_type;
+            uint32_t use_mesh_color;
+            uint32_t do_lighting;
+        };
+
+        struct TransformRecord {
+            glm::vec3 position;
+            glm::quat rotation;
+            glm::vec3 scale;
+        };
+
+        struct StaticModelRecord {
+            uint32_t model;
+        };
+
+        struct LightRecord {
+            glm::vec3 color;
+            float intensity;
+        };
+
+        struct ParentRecord {
+            EntityID parent;
+        };
+
+        /// Append-only binary buffer.
+        class Writer {
+        public:
+            template<typename T>
+            void write(const T &value) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                const auto *bytes = reinterpret_cast<const std::byte *>(&value);
+                data.insert(data.end(), bytes, bytes + sizeof(T));
+            }
+
+            /// Write the amount of values, then the values themselves at an aligned position.
+            template<typename T>
+            void write_array(const std::span<const T> values) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                write<uint64_t>(values.size());
+                align();
+                const auto *bytes = reinterpret_cast<const std::byte *>(values.data());
+                data.insert(data.end(), bytes, bytes + values.size_bytes());
+            }
+
+            void write_string(const std::string_view value) {
+                write<uint64_t>(value.size());
+                const auto *bytes = reinterpret_cast<const std::byte *>(value.data());
+                data.insert(data.end(), bytes, bytes + value.size());
+            }
+
+            void begin_section(const SectionKind kind) {
+                align();
+                section_start = data.size();
+                write(SectionHeader{kind, 0, 0});
+            }
+
+            void end_section() {
+                const uint64_t size = data.size() - section_start - sizeof(SectionHeader);
+                std::memcpy(data.data() + section_start + offsetof(SectionHeader, size), &size, sizeof(size));
+            }
+
+            [[nodiscard]] const std::vector<std::byte> &get_data() const { return data; }
+
+        private:
+            std::vector<std::byte> data;
+            size_t section_start = 0;
+
+            void align() { data.resize((data.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT); }
+        };
+
+        /// Bounds-checked reads from a byte range. Arrays are returned as spans into the range.
+        class Reader {
+        public:
+            explicit Reader(const std::span<const std::byte> data) : data(data) {}
+
+            template<typename T>
+            T read() {
+                static_assert(std::is_trivially_copyable_v<T>);
+                T value;
+                std::memcpy(&value, take(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            template<typename T>
+            std::span<const T> read_array() {
+                const uint64_t count = read<uint64_t>();
+                align();
+                if (count > (data.size() - offset) / sizeof(T))
+                    throw std::runtime_error("Truncated snapshot");
+                return {reinterpret_cast<const T *>(take(count * sizeof(T))), count};
+            }
+
+            std::string read_string() {
+                const uint64_t size = read<uint64_t>();
+                const auto *chars = reinterpret_cast<const char *>(take(size));
+                return {chars, size};
+            }
+
+            /// Return a reader over the next size bytes, and skip them.
+            Reader sub_reader(const size_t size) {
+                const size_t position = offset;
+                take(size);
+                return Reader(data.subspan(position, size), base + position);
+            }
+
+            void align() {
+                // Alignment is relative to the start of the file
+                const size_t absolute = base + offset;
+                offset += (ALIGNMENT - absolute % ALIGNMENT) % ALIGNMENT;
+                if (offset > data.size())
+                    throw std::runtime_error("Truncated snapshot");
+            }
+
+            [[nodiscard]] bool at_end() const { return offset == data.size(); }
+
+        private:
+            std::span<const std::byte> data;
+            size_t offset = 0;
+            // Position of data in the file
+            size_t base = 0;
+
+            Reader(const std::span<const std::byte> data, const size_t base) : data(data), base(base) {}
+
+            const std::byte *take(const size_t size) {
+                if (size > data.size() - offset)
+                    throw std::runtime_error("Truncated snapshot");
+                const std::byte *res = data.data() + offset;
+                offset += size;
+                return res;
+            }
+        };
+
+        /// Read-only memory mapping of a whole file.
+        class MappedFile {
+        public:
+            explicit MappedFile(const std::string &path) {
+                const int fd = open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                    throw std::runtime_error(std::format("Unable to open snapshot {}", path));
+
+                struct stat st{};
+                if (fstat(fd, &st) != 0) {
+                    close(fd);
+                    throw std::runtime_error(std::format("Unable to read snapshot {}", path));
+                }
+                size = static_cast<size_t>(st.st_size);
+
+                if (size > 0) {
+                    address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                }
+                close(fd);
+
+                if (address == MAP_FAILED)
+                    throw std::runtime_error(std::format("Unable to map snapshot {}", path));
+            }
+
+            ~MappedFile() {
+                if (address != MAP_FAILED)
+                    munmap(address, size);
+            }
+
+            MappedFile(const MappedFile &other) = delete;
+            MappedFile &operator=(const MappedFile &other) = delete;
+
+            [[nodiscard]] std::span<const std::byte> get_data() const {
+                if (address == MAP_FAILED)
+                    return {};
+                return {static_cast<const std::byte *>(address), size};
+            }
+
+        private:
+            void *address = MAP_FAILED;
+            size_t size = 0;
+        };
+
+        /// Resources of type R written in a snapshot, indexed by their position in the section.
+        template<ResourceConcept R>
+        class ResourceTable {
+        public:
+            explicit ResourceTable(World &world) : world(world) {}
+
+            /// Add the resource to the table if it is not already in it.
+            void add(const Rc<R> &resource) {
+                if (is_default(resource) || indices.contains(resource.get()))
+                    return;
+                indices.emplace(resource.get(), static_cast<uint32_t>(resources.size()));
+                resources.push_back(resource);
+            }
+
+            /// Add every resource of type R of the world.
+            void add_pool() {
+                const TypeId type_id = resource_type_id<R>();
+                // A copy: kept alive while iterating
+                const ResourcePool pool = world.get_resources();
+                if (type_id >= pool.size())
+                    return;
+                for (const auto &resource: pool[type_id] | std::views::values)
+                    add(resource.template as<R>());
+            }
+
+            /// Reference to the resource, which must have been added.
+            [[nodiscard]] uint32_t ref(const Rc<R> &resource) const {
+                if (is_default(resource))
+                    return DEFAULT_RESOURCE;
+                return indices.at(resource.get());
+            }
+
+            [[nodiscard]] uint32_t ref(const std::optional<Rc<R>> &resource) const {
+                return resource.has_value() ? ref(resource.value()) : NO_RESOURCE;
+            }
+
+            [[nodiscard]] const std::vector<Rc<R>> &get_resources() const { return resources; }
+
+        private:
+            World &world;
+            std::vector<Rc<R>> resources;
+            std::unordered_map<const R *, uint32_t> indices;
+
+            [[nodiscard]] bool is_default(const Rc<R> &resource) const {
+                return world.get_default<R>().get() == resource.get();
+            }
+        };
+
+        /// Resolve a reference read from a snapshot.
+        template<ResourceConcept R>
+        Rc<R> resolve(World &world, const std::vector<Rc<R>> &table, const uint32_t ref) {
+            if (ref == DEFAULT_RESOURCE)
+                return world.get_default<R>();
+            if (ref >= table.size())
+                throw std::runtime_error("Snapshot references an unknown resource");
+            return table[ref];
+        }
+
+        template<ResourceConcept R>
+        std::optional<Rc<R>> resolve_opt(World &world, const std::vector<Rc<R>> &table, const uint32_t ref) {
+            if (ref == NO_RESOURCE)
+                return std::nullopt;
+            return resolve(world, table, ref);
+        }
+
+        /// Write a section holding the entities having a component C, then one Record per component.
+        template<ComponentConcept C, typename Record, typename ToRecord>
+        void write_components(World &world, Writer &writer, const SectionKind kind, ToRecord &&to_record) {
+            std::vector<EntityID> entities;
+            std::vector<Record> records;
+            for (const auto &[entity, component]: world.view<C>()) {
+                entities.push_back(entity);
+                records.push_back(to_record(component));
+            }
+            if (entities.empty())
+                return;
+
+            writer.begin_section(kind);
+            writer.write_array(std::span<const EntityID>(entities));
+            writer.write_array(std::span<const Record>(records));
+            writer.end_section();
+        }
+
+        /// Texture of a snapshot, before it is created.
+        struct TextureEntry {
+            std::string name;
+            std::string path;
+            aiTextureType type;
+            bool flip;
+        };
+
+        /// Material of a snapshot, before it is created.
+        struct MaterialEntry {
+            std::string name;
+            MaterialRecord record;
+        };
+
+        /// Model of a snapshot, before it is created. The arrays point into the mapped file.
+        struct ModelEntry {
+            std::string name;
+            std::span<const uint32_t> material_refs;
+            std::span<const uint32_t> mesh_materials;
+            std::span<const uint64_t> starts;
+            std::span<const uint64_t> sizes;
+            std::span<const rsc::Vertex> vertices;
+            std::span<const rsc::VertexID> elements;
+        };
+
+        /// Entity tables of a snapshot. The arrays point into the mapped file.
+        struct EntityTables {
+            std::span<const EntityGeneration> generations;
+            std::span<const uint32_t> positions;
+            std::span<const EntityID> alive;
+            std::span<const EntityIndex> free;
+            std::vector<std::pair<EntityIndex, std::string>> names;
+
+            /// Returns true if the entity is alive in the tables, which must have been validated.
+            [[nodiscard]] bool is_alive(const EntityID id) const {
+                const EntityIndex index = entity_index(id);
+                return index < positions.size() && positions[index] < alive.size() && alive[positions[index]] == id;
+            }
+        };
+
+        /// Section written by write_components. The arrays point into the mapped file.
+        template<typename Record>
+        struct ComponentSection {
+            std::span<const EntityID> entities;
+            std::span<const Record> records;
+
+            void read(Reader &reader) {
+                entities = reader.read_array<EntityID>();
+                records = reader.read_array<Record>();
+                if (entities.size() != records.size())
+                    throw std::runtime_error("Corrupted snapshot: component count mismatch");
+            }
+
+            /// Check that the entities are alive in the tables, and distinct.
+            void validate(const EntityTables &tables) const {
+                std::vector<bool> seen(tables.positions.size(), false);
+                for (const EntityID id: entities) {
+                    if (!tables.is_alive(id) || seen[entity_index(id)])
+                        throw std::runtime_error("Corrupted snapshot: component of an invalid entity");
+                    seen[entity_index(id)] = true;
+                }
+            }
+
+            /// Attach the components in one batch. make_args(record) returns the tuple of constructor arguments
+            /// of a component.
+            template<ComponentConcept C, typename MakeArgs>
+            void attach(World &world, MakeArgs &&make_args) const {
+                world.attach_components_from<C>(entities, [&](const size_t i) { return make_args(records[i]); });
+            }
+        };
+
+        /// Content of a snapshot, read and validated before anything is given to the World.
+        struct Contents {
+            std::vector<TextureEntry> textures;
+            std::vector<MaterialEntry> materials;
+            std::vector<ModelEntry> models;
+            EntityTables entities;
+            ComponentSection<TransformRecord> transforms;
+            ComponentSection<StaticModelRecord> static_models;
+            ComponentSection<LightRecord> point_lights;
+            ComponentSection<LightRecord> directional_lights;
+            ComponentSection<ParentRecord> parents;
+        };
+
+        /// Check a resource reference read from a snapshot (see resolve).
+        void validate_ref(const uint32_t ref, const size_t table_size, const bool optional) {
+            if (ref == DEFAULT_RESOURCE || (optional && ref == NO_RESOURCE))
+                return;
+            if (ref >= table_size)
+                throw std::runtime_error("Snapshot references an unknown resource");
+        }
+
+        /// Check that the geometry of a model is consistent, so that from_geometry can not fail on it.
+        void validate_model(const ModelEntry &model, const size_t material_count) {
+            for (const uint32_t ref: model.material_refs)
+                validate_ref(ref, material_count, false);
+
+            if (model.mesh_materials.size() != model.starts.size() || model.sizes.size() != model.starts.size())
+                throw std::runtime_error("Corrupted snapshot: inconsistent mesh ranges");
+            for (size_t i = 0; i < model.starts.size(); i++) {
+                if (model.mesh_materials[i] >= model.material_refs.size() ||
+                    model.starts[i] > model.elements.size() || model.sizes[i] > model.elements.size() - model.starts[i])
+                    throw std::runtime_error("Corrupted snapshot: invalid mesh range");
+            }
+
+            if (!model.elements.empty() && std::ranges::max(model.elements) >= model.vertices.size())
+                throw std::runtime_error("Corrupted snapshot: element out of the vertices");
+        }
+    } // namespace
+
+    void Snapshot::save(World &world, const std::string &path) {
+        // Gather every resource reachable from the saved components, and those of the pools
+        ResourceTable<rsc::Model> models(world);
+        ResourceTable<rsc::Material> materials(world);
+        ResourceTable<rsc::Texture> textures(world);
+
+        models.add_pool();
+        for (const auto &[entity, static_model]: world.view<cpt::StaticModel>())
+            models.add(static_model.get_model());
+
+        materials.add_pool();
+        for (const auto &model: models.get_resources()) {
+            for (const auto &material: model->get_materials())
+                materials.add(material);
+        }
+
+        textures.add_pool();
+        for (const auto &material: materials.get_resources()) {
+            if (const auto diffuse = material->get_diffuse_map())
+                textures.add(diffuse.value());
+            if (const auto specular = material->get_specular_map())
+                textures.add(specular.value());
+        }
+
+        Writer writer;
+        writer.write(Header{MAGIC, VERSION, sizeof(rsc::Vertex), sizeof(EntityID)});
+
+        // Textures are reloaded from their file
+        writer.begin_section(TEXTURES_SECTION);
+        writer.write<uint64_t>(textures.get_resources().size());
+        for (const auto &texture: textures.get_resources()) {
+            writer.write_string(texture->get_name());
+            writer.write_string(texture->get_path());
+            writer.write<uint32_t>(texture->get_texture_type());
+            writer.write<uint32_t>(texture->is_flipped());
+        }
+        writer.end_section();
+
+        writer.begin_section(MATERIALS_SECTION);
+        writer.write<uint64_t>(materials.get_resources().size());
+        for (const auto &material: materials.get_resources()) {
+            writer.write_string(material->get_name());
+            writer.write(MaterialRecord{
+                    material->get_diffuse_color(),
+                    material->get_specular_intensity(),
+                    material->get_shininess(),
+                    textures.ref(material->get_diffuse_map()),
+                    textures.ref(material->get_specular_map()),
+                    material->get_primitive_type(),
+                    material->is_using_mesh_color(),
+                    material->is_doing_lighting(),
+            });
+        }
+        writer.end_section();
+
+        // Models are saved aggregated: restoring them does not recreate their Mesh resources
+        writer.begin_section(MODELS_SECTION);
+        writer.write<uint64_t>(models.get_resources().size());
+        for (const auto &model: models.get_resources()) {
+            const auto &model_materials = model->get_materials();
+
+            std::vector<uint32_t> material_refs;
+            material_refs.reserve(model_materials.size());
+            // Index in model_materials of the material of each mesh. Meshes of other materials are not drawn.
+            std::vector<uint32_t> mesh_materials(model->get_meshes_start().size(), NO_RESOURCE);
+            for (const auto &[i, material]: model_materials | std::views::enumerate) {
+                material_refs.push_back(materials.ref(material));
+                for (const unsigned mesh: model->get_material_meshes(material->get_name()))
+                    mesh_materials[mesh] = static_cast<uint32_t>(i);
+            }
+
+            const std::vector<uint64_t> starts(model->get_meshes_start().begin(), model->get_meshes_start().end());
+            const std::vector<uint64_t> sizes(model->get_meshes_size().begin(), model->get_meshes_size().end());
+
+            writer.write_string(model->get_name());
+            writer.write_array(std::span<const uint32_t>(material_refs));
+            writer.write_array(std::span<const uint32_t>(mesh_materials));
+            writer.write_array(std::span<const uint64_t>(starts));
+            writer.write_array(std::span<const uint64_t>(sizes));
+            writer.write_array(std::span<const rsc::Vertex>(model->get_vertices()));
+            writer.write_array(std::span<const rsc::VertexID>(model->get_elements()));
+        }
+        writer.end_section();
+
+        // The entity table is saved as is, so that entities keep their IDs
+        writer.begin_section(ENTITIES_SECTION);
+        writer.write_array(std::span<const EntityGeneration>(world.entity_generations));
+        writer.write_array(std::span<const uint32_t>(world.entity_positions));
+        writer.write_array(std::span<const EntityID>(world.alive_entities));
+        writer.write_array(std::span<const EntityIndex>(world.free_entities));
+        std::vector<EntityID> named;
+        for (const EntityID id: world.alive_entities) {
+            if (world.entity_names[entity_index(id)].name != NO_NAME)
+                named.push_back(id);
+        }
+        writer.write<uint64_t>(named.size());
+        for (const EntityID id: named) {
+            writer.write<EntityIndex>(entity_index(id));
+            writer.write_string(world.get_name(id));
+        }
+        writer.end_section();
+
+        write_components<cpt::Transform, TransformRecord>(
+                world, writer, TRANSFORMS_SECTION, [](const cpt::Transform &transform) {
+                    return TransformRecord{transform.get_position(), transform.get_rotation(), transform.get_scale()};
+                });
+        write_components<cpt::StaticModel, StaticModelRecord>(
+                world, writer, STATIC_MODELS_SECTION, [&models](const cpt::StaticModel &static_model) {
+                    return StaticModelRecord{models.ref(static_model.get_model())};
+                });
+        write_components<cpt::PointLight, LightRecord>(
+                world, writer, POINT_LIGHTS_SECTION, [](const cpt::PointLight &light) {
+                    return LightRecord{light.get_color(), light.get_intensity()};
+                });
+        write_components<cpt::DirectionalLight, LightRecord>(
+                world, writer, DIRECTIONAL_LIGHTS_SECTION, [](const cpt::DirectionalLight &light) {
+                    return LightRecord{light.get_color(), light.get_intensity()};
+                });
+        write_components<cpt::Parent, ParentRecord>(world, writer, PARENTS_SECTION, [](const cpt::Parent &parent) {
+            return ParentRecord{parent.get_parent()};
+        });
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(writer.get_data().data()),
+                   static_cast<std::streamsize>(writer.get_data().size()));
+        if (!file)
+            throw std::runtime_error(std::format("Unable to write snapshot {}", path));
+
+        wrldInfo(std::format("Saved snapshot {} ({} entities, {} models)", path, world.alive_entities.size(),
+                             models.get_resources().size()));
+    }
+
+    void Snapshot::load(World &world, const std::string &path) {
+        // Entity IDs are restored with their generations: a world which ever created entities (even deleted
+        // or reserved by a CommandBuffer) could have handed out IDs that the snapshot would make valid again
+        if (world.entity_generations.size() != 1 || world.reserved_entities != 0)
+            throw std::runtime_error("Snapshots can only be loaded in a world which never created entities");
+
+        const MappedFile file(path);
+        Reader reader(file.get_data());
+
+        const auto header = reader.read<Header>();
+        if (header.magic != MAGIC)
+            throw std::runtime_error(std::format("{} is not a snapshot", path));
+        if (header.version != VERSION || header.vertex_size != sizeof(rsc::Vertex) ||
+            header.entity_id_size != sizeof(EntityID))
+            throw std::runtime_error(std::format("Snapshot {} was written by another version (format {}, expected {})",
+                                                 path, header.version, VERSION));
+
+        // Everything is read and validated first: the World is only changed once the whole file is known to be
+        // valid, so that a stale or corrupted snapshot leaves it untouched
+        Contents contents;
+        uint64_t read_sections = 0;
+
+        while (!reader.at_end()) {
+            reader.align();
+            const auto section = reader.read<SectionHeader>();
+            Reader content = reader.sub_reader(section.size);
+
+            if (section.kind < 64) {
+                if (read_sections & uint64_t{1} << section.kind)
+                    throw std::runtime_error("Corrupted snapshot: duplicated section");
+                read_sections |= uint64_t{1} << section.kind;
+            }
+
+            switch (section.kind) {
+                case TEXTURES_SECTION: {
+                    const auto count = content.read<uint64_t>();
+                    for (uint64_t i = 0; i < count; i++) {
+                        TextureEntry &texture = contents.textures.emplace_back();
+                        texture.name = content.read_string();
+                        texture.path = content.read_string();
+                        texture.type = static_cast<aiTextureType>(content.read<uint32_t>());
+                        texture.flip = content.read<uint32_t>() != 0;
+                    }
+                } break;
+
+                case MATERIALS_SECTION: {
+                    const auto count = content.read<uint64_t>();
+                    for (uint64_t i = 0; i < count; i++) {
+                        MaterialEntry &material = contents.materials.emplace_back();
+                        material.name = content.read_string();
+                        material.record = content.read<MaterialRecord>();
+                    }
+                } break;
+
+                case MODELS_SECTION: {
+                    const auto count = content.read<uint64_t>();
+                    for (uint64_t i = 0; i < count; i++) {
+                        ModelEntry &model = contents.models.emplace_back();
+                        model.name = content.read_string();
+                        model.material_refs = content.read_array<uint32_t>();
+                        model.mesh_materials = content.read_array<uint32_t>();
+                        model.starts = content.read_array<uint64_t>();
+                        model.sizes = content.read_array<uint64_t>();
+                        model.vertices = content.read_array<rsc::Vertex>();
+                        model.elements = content.read_array<rsc::VertexID>();
+                    }
+                } break;
+
+                case ENTITIES_SECTION: {
+                    EntityTables &tables = contents.entities;
+                    tables.generations = content.read_array<EntityGeneration>();
+                    tables.positions = content.read_array<uint32_t>();
+                    tables.alive = content.read_array<EntityID>();
+                    tables.free = content.read_array<EntityIndex>();
+                    validate_entity_tables(tables.generations, tables.positions, tables.alive, tables.free);
+
+                    const auto name_count = content.read<uint64_t>();
+                    for (uint64_t i = 0; i < name_count; i++) {
+                        const auto index = content.read<EntityIndex>();
+                        std::string name = content.read_string();
+                        if (index >= tables.generations.size() || tables.positions[index] == World::NO_POSITION)
+                            throw std::runtime_error("Corrupted snapshot: name of a dead entity");
+                        tables.names.emplace_back(index, std::move(name));
+                    }
+                } break;
+
+                case TRANSFORMS_SECTION: {
+                    contents.transforms.read(content);
+                } break;
+
+                case STATIC_MODELS_SECTION: {
+                    contents.static_models.read(content);
+                } break;
+
+                case POINT_LIGHTS_SECTION: {
+                    contents.point_lights.read(content);
+                } break;
+
+                case DIRECTIONAL_LIGHTS_SECTION: {
+                    contents.directional_lights.read(content);
+                } break;
+
+                case PARENTS_SECTION: {
+                    contents.parents.read(content);
+                } break;
+
+                default:
+                    // Written by a newer version, skipped
+                    break;
+            }
+        }
+
+        for (const MaterialEntry &material: contents.materials) {
+            validate_ref(material.record.diffuse_map, contents.textures.size(), true);
+            validate_ref(material.record.specular_map, contents.textures.size(), true);
+        }
+        for (const ModelEntry &model: contents.models)
+            validate_model(model, contents.materials.size());
+
+        contents.transforms.validate(contents.entities);
+        contents.static_models.validate(contents.entities);
+        contents.point_lights.validate(contents.entities);
+        contents.directional_lights.validate(contents.entities);
+        contents.parents.validate(contents.entities);
+        for (const StaticModelRecord &record: contents.static_models.records)
+            validate_ref(record.model, contents.models.size(), false);
+        for (size_t i = 0; i < contents.parents.entities.size(); i++) {
+            if (contents.parents.records[i].parent == contents.parents.entities[i])
+                throw std::runtime_error("Corrupted snapshot: entity parent of itself");
+        }
+
+        // Resources. Textures are decoded in the background, and arrive through the loader's per-frame budget
+        std::vector<Rc<rsc::Texture>> textures;
+        textures.reserve(contents.textures.size());
+        for (const TextureEntry &entry: contents.textures) {
+            textures.push_back(world.create_resource<rsc::Texture>(entry.name));
+            textures.back().get_mut()->set_texture_async(entry.path, entry.type, entry.flip);
+        }
+
+        std::vector<Rc<rsc::Material>> materials;
+        materials.reserve(contents.materials.size());
+        for (const auto &[name, record]: contents.materials) {
+            auto material = world.create_resource<rsc::Material>(name);
+            rsc::Material &mat = *material.get_mut();
+            mat.set_diffuse_color(record.diffuse_color);
+            mat.set_specular_intensity(record.specular_intensity);
+            mat.set_shininess(record.shininess);
+            if (const auto map = resolve_opt(world, textures, record.diffuse_map))
+                mat.set_diffuse_map(map.value());
+            if (const auto map = resolve_opt(world, textures, record.specular_map))
+                mat.set_specular_map(map.value());
+            mat.set_primitive_type(record.primitive_type);
+            mat.use_mesh_color(record.use_mesh_color != 0);
+            mat.do_lighting(record.do_lighting != 0);
+            materials.push_back(material);
+        }
+
+        std::vector<Rc<rsc::Model>> models;
+        models.reserve(contents.models.size());
+        for (const ModelEntry &entry: contents.models) {
+            std::vector<Rc<rsc::Material>> model_materials;
+            model_materials.reserve(entry.material_refs.size());
+            for (const uint32_t ref: entry.material_refs)
+                model_materials.push_back(resolve(world, materials, ref));
+
+            models.push_back(world.create_resource<rsc::Model>(entry.name));
+            models.back().get_mut()->from_geometry(entry.vertices, entry.elements, entry.starts, entry.sizes,
+                                                   entry.mesh_materials, model_materials);
+        }
+
+        // Entities
+        const EntityTables &tables = contents.entities;
+        if (!tables.generations.empty()) {
+            world.entity_generations.assign(tables.generations.begin(), tables.generations.end());
+            world.entity_positions.assign(tables.positions.begin(), tables.positions.end());
+            world.alive_entities.assign(tables.alive.begin(), tables.alive.end());
+            world.free_entities.assign(tables.free.begin(), tables.free.end());
+            world.entity_signatures.assign(tables.generations.size(), ComponentSignature());
+            world.entity_names.assign(tables.generations.size(), World::EntityName());
+            world.named_entities.clear();
+        }
+        for (const auto &[index, name]: tables.names) {
+            world.set_entity_name(make_entity_id(index, world.entity_generations[index]),
+                                  world.entity_name_strings.intern(name));
+        }
+
+        // Components
+        contents.transforms.attach<cpt::Transform>(world, [](const TransformRecord &record) {
+            return std::tuple{record.position, record.rotation, record.scale};
+        });
+        contents.static_models.attach<cpt::StaticModel>(world, [&](const StaticModelRecord &record) {
+            return std::tuple{resolve(world, models, record.model)};
+        });
+        contents.point_lights.attach<cpt::PointLight>(
+                world, [](const LightRecord &record) { return std::tuple{record.color, record.intensity}; });
+        contents.directional_lights.attach<cpt::DirectionalLight>(
+                world, [](const LightRecord &record) { return std::tuple{record.color, record.intensity}; });
+        contents.parents.attach<cpt::Parent>(world,
+                                             [](const ParentRecord &record) { return std::tuple{record.parent}; });
+
+        wrldInfo(std::format("Loaded snapshot {} ({} entities, {} models)", path, world.alive_entities.size(),
+                             models.size()));
+    }
+
+    void Snapshot::validate_entity_tables(const std::span<const EntityGeneration> generations,
+                                          const std::span<const uint32_t> positions,
+                                          const std::span<const EntityID> alive,
+                                          const std::span<const EntityIndex> free) {
+        const auto corrupted = [](const std::string_view what) {
+            return std::runtime_error(std::format("Corrupted snapshot: {}", what));
+        };
+
+        if (generations.empty() || positions.size() != generations.size() || positions[0] != World::NO_POSITION)
+            throw corrupted("invalid entity table");
+        if (alive.size() >= generations.size())
+            throw corrupted("more alive entities than indices");
+
+        for (size_t position = 0; position < alive.size(); position++) {
+            const EntityIndex index = entity_index(alive[position]);
+            if (index == 0 || index >= generations.size() || positions[index] != position ||
+                generations[index] != entity_generation(alive[position]))
+                throw corrupted("alive entity not at its position");
+        }
+
+        // Each alive entity has its position, so any other position belongs to no entity
+        size_t positioned = 0;
+        for (const uint32_t position: positions) {
+            if (position != World::NO_POSITION)
+                positioned += 1;
+        }
+        if (positioned != alive.size())
+            throw corrupted("position of a dead entity");
+
+        std::vector<bool> freed(generations.size(), false);
+        for (const EntityIndex index: free) {
+            if (index == 0 || index >= generations.size() || positions[index] != World::NO_POSITION ||
+                freed[index])
+                throw corrupted("invalid free index");
+            freed[index] = true;
+        }
+    }
+} // namespace wrld
@@ -0,0 +1,36 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/StringInterner.hpp>
+
+#include <format>
+#include <stdexcept>
+
+namespace wrld {
+    NameID StringInterner::intern(const std::string_view string) {
+        if (const auto it = ids.find(string); it != ids.end())
+            return it->second;
+
+        if (strings.size() >= NO_NAME)
+            throw std::runtime_error("Too many interned strings");
+
+        const auto id = static_cast<NameID>(strings.size());
+        const std::string &stored = strings.emplace_back(string);
+        ids.emplace(stored, id);
+        return id;
+    }
+
+    NameID StringInterner::find(const std::string_view string) const {
+        const auto it = ids.find(string);
+        return it == ids.end() ? NO_NAME : it->second;
+    }
+
+    std::string_view StringInterner::get(const NameID id) const {
+        if (id >= strings.size())
+            throw std::runtime_error(std::format("No string interned with ID {}", id));
+        return strings[id];
+    }
+
+    size_t StringInterner::size() const { return strings.size(); }
+} // namespace wrld
@@ -5,5 +5,22 @@
 #include <wrld/System.hpp>
 
 namespace wrld {
+    bool SystemAccess::conflicts_with(const SystemAccess &other) const {
+        if (exclusive || other.exclusive)
+            return true;
+
+        // Concurrent reads are fine, a write conflicts with any other access
+        return (writes & (other.reads | other.writes)).any() || (other.writes & reads).any();
+    }
+
     System::System(World &world) : world(world) {}
+
+    void System::run() {
+        exec();
+        last_run_tick = world.advance_tick();
+    }
+
+    const SystemAccess &System::get_access() const { return access; }
+
+    void System::pin_to_main_thread() { access.main_thread = true; }
 } // namespace wrld
@@ -0,0 +1,114 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/ThreadPool.hpp>
+
+#include <algorithm>
+
+namespace wrld {
+    namespace {
+        // Pool and queue of the worker running on this thread, if any
+        thread_local const ThreadPool *current_pool = nullptr;
+        thread_local size_t current_queue = 0;
+    } // namespace
+
+    ThreadPool::ThreadPool(size_t thread_count) {
+        if (thread_count == 0)
+            thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+
+        queues.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; i++)
+            queues.push_back(std::make_unique<WorkerQueue>());
+
+        workers.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; i++)
+            workers.emplace_back(&ThreadPool::work, this, i);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            const std::lock_guard lock(sleep_mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+
+        for (auto &worker: workers)
+            worker.join();
+    }
+
+    void ThreadPool::submit(std::function<void()> task) {
+        const size_t queue = current_pool == this ? current_queue
+                                                  : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        {
+            const std::lock_guard lock(queues[queue]->mutex);
+            queues[queue]->tasks.push_back(std::move(task));
+        }
+        queued.fetch_add(1, std::memory_order_release);
+
+        // Taking the lock ensures a worker checking for tasks before sleeping does not miss this one
+        { const std::lock_guard lock(sleep_mutex); }
+        condition.notify_one();
+    }
+
+    bool ThreadPool::run_pending_task() {
+        const auto task = take_task(current_pool == this ? current_queue : 0);
+        if (!task)
+            return false;
+
+        task();
+        return true;
+    }
+
+    size_t ThreadPool::get_thread_count() const { return workers.size(); }
+
+    std::function<void()> ThreadPool::take_task(const size_t first_queue) {
+        if (queued.load(std::memory_order_acquire) == 0)
+            return {};
+
+        // Own queue: most recent task, its data is likely still in cache
+        {
+            WorkerQueue &queue = *queues[first_queue];
+            const std::lock_guard lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                auto task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+
+        // Steal the oldest task of another queue
+        for (size_t offset = 1; offset < queues.size(); offset++) {
+            WorkerQueue &queue = *queues[(first_queue + offset) % queues.size()];
+            const std::lock_guard lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                auto task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+
+        return {};
+    }
+
+    void ThreadPool::work(const size_t index) {
+        current_pool = this;
+        current_queue = index;
+
+        while (true) {
+            if (const auto task = take_task(index)) {
+                task();
+                continue;
+            }
+
+            std::unique_lock lock(sleep_mutex);
+            condition.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+
+            // Finish the pending tasks before stopping
+            if (stopping && queued.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+} // namespace wrld
@@ -4,57 +4,352 @@
 
 #include <wrld/World.hpp>
 
-#include <random>
+#include <algorithm>
 #include <ranges>
 
 namespace wrld {
-    World::World() : components({}) {}
+    World::World() :
+        entity_generations({0}), entity_positions({NO_POSITION}), entity_signatures(1), entity_names(1),
+        gpu_memory(std::make_unique<GpuMemory>()), resource_registry(std::make_unique<ResourceRegistry>()),
+        command_buffer(std::make_unique<CommandBuffer>(*this)),
+        resource_loader(std::make_unique<ResourceLoader>(*this)), file_watcher(std::make_unique<FileWatcher>(*this)),
+        thread_pool(std::make_unique<ThreadPool>()),
+        scheduler(std::make_unique<Scheduler>(*this, *thread_pool)) {}
+
+    World::~World() = default;
 
     EntityID World::create_entity(const std::string &name) {
-        max_entity_id += 1;
-        EntityID res = max_entity_id;
+        const EntityID res = reserve_entity();
+        activate_entity(res, name);
+        return res;
+    }
 
-        if (name.empty())
-            entities.emplace(res, std::format("#{}", res));
-        else
-            entities.emplace(res, name);
+    std::span<const EntityID> World::create_entities(const size_t count, const std::string &name) {
+        const size_t first = alive_entities.size();
+        grow_reserved_entities();
 
-        return res;
+        // Grow every table once
+        alive_entities.reserve(first + count);
+        if (count > free_entities.size()) {
+            entity_generations.reserve(entity_generations.size() + count - free_entities.size());
+            entity_positions.reserve(entity_positions.size() + count - free_entities.size());
+            entity_signatures.reserve(entity_signatures.size() + count - free_entities.size());
+            entity_names.reserve(entity_names.size() + count - free_entities.size());
+        }
+        // The name is interned once for all the entities
+        const NameID name_id = name.empty() ? NO_NAME : entity_name_strings.intern(name);
+        for (size_t i = 0; i < count; i++) {
+            const EntityID id = reserve_entity();
+            activate_entity(id, "");
+            if (name_id != NO_NAME)
+                set_entity_name(id, name_id);
+        }
+
+        return std::span<const EntityID>(alive_entities).subspan(first, count);
+    }
+
+    EntityID World::reserve_entity() {
+        // Slots reserved by the CommandBuffer come first
+        grow_reserved_entities();
+
+        EntityIndex index;
+        if (!free_entities.empty()) {
+            index = free_entities.back();
+            free_entities.pop_back();
+        } else {
+            index = static_cast<EntityIndex>(entity_generations.size());
+            entity_generations.push_back(0);
+            entity_positions.push_back(NO_POSITION);
+            entity_signatures.emplace_back();
+            entity_names.emplace_back();
+        }
+
+        return make_entity_id(index, entity_generations[index]);
+    }
+
+    EntityID World::reserve_entity_deferred() {
+        if (!free_entities.empty()) {
+            // Popping never reallocates, and free slots are not read by systems
+            const EntityIndex index = free_entities.back();
+            free_entities.pop_back();
+            return make_entity_id(index, entity_generations[index]);
+        }
+
+        const auto index = static_cast<EntityIndex>(entity_generations.size() + reserved_entities);
+        reserved_entities += 1;
+        // New slots start at generation 0
+        return make_entity_id(index, 0);
+    }
+
+    void World::grow_reserved_entities() {
+        if (reserved_entities == 0)
+            return;
+
+        const size_t size = entity_generations.size() + reserved_entities;
+        entity_generations.resize(size, 0);
+        entity_positions.resize(size, NO_POSITION);
+        entity_signatures.resize(size);
+        entity_names.resize(size);
+        reserved_entities = 0;
+    }
+
+    void World::activate_entity(const EntityID id, const std::string &name) {
+        const EntityIndex index = entity_index(id);
+        entity_positions[index] = static_cast<uint32_t>(alive_entities.size());
+        alive_entities.push_back(id);
+
+        if (!name.empty())
+            set_entity_name(id, entity_name_strings.intern(name));
+    }
+
+    void World::set_entity_name(const EntityID id, const NameID name) {
+        if (name >= named_entities.size())
+            named_entities.resize(name + 1);
+
+        std::vector<EntityID> &entities = named_entities[name];
+        entity_names[entity_index(id)] = {name, static_cast<uint32_t>(entities.size())};
+        entities.push_back(id);
+    }
+
+    void World::clear_entity_name(const EntityIndex index) {
+        const EntityName name = entity_names[index];
+        if (name.name == NO_NAME)
+            return;
+
+        // Swap-remove from the entities having this name
+        std::vector<EntityID> &entities = named_entities[name.name];
+        const EntityID last = entities.back();
+        entities[name.position] = last;
+        entity_names[entity_index(last)].position = name.position;
+        entities.pop_back();
+        entity_names[index] = {};
+    }
+
+    std::string_view World::get_name(const EntityID id) const {
+        if (!entity_exists(id))
+            return {};
+
+        const NameID name = entity_names[entity_index(id)].name;
+        return name == NO_NAME ? std::string_view() : entity_name_strings.get(name);
+    }
+
+    std::string World::get_entity_name(const EntityID id) const {
+        if (const std::string_view name = get_name(id); !name.empty())
+            return std::string(name);
+        return std::format("#{}", entity_index(id));
     }
 
-    std::string World::get_entity_name(const EntityID id) { return entities[id]; }
+    EntityID World::find_entity_by_name(const std::string_view name) const {
+        const std::span<const EntityID> entities = find_entities_by_name(name);
+        return entities.empty() ? NULL_ENTITY : entities.front();
+    }
+
+    std::span<const EntityID> World::find_entities_by_name(const std::string_view name) const {
+        const NameID id = entity_name_strings.find(name);
+        if (id == NO_NAME || id >= named_entities.size())
+            return {};
+        return named_entities[id];
+    }
 
     void World::delete_entity(const EntityID id) {
         if (!entity_exists(id))
             return;
 
-        entities.erase(id);
-        for (auto &component_pool: components | std::views::values) {
-            component_pool.erase(id);
+        // Only visit the storages holding a component of the entity
+        const EntityIndex index = entity_index(id);
+        const ComponentSignature signature = entity_signatures[index];
+
+        // Observers see the entity as it was. Tags have no storage.
+        for (TypeId type_id = 0; type_id < components.size(); type_id++) {
+            if (signature.test(type_id) && components[type_id])
+                notify(REMOVE_EVENT, type_id, id, *components[type_id]->find_component(id));
+        }
+
+        entity_signatures[index].reset();
+        for (TypeId type_id = 0; type_id < components.size(); type_id++) {
+            if (signature.test(type_id) && components[type_id]) {
+                update_queries(id, type_id);
+                components[type_id]->remove(id);
+            }
+        }
+
+        clear_entity_name(index);
+
+        // Swap-remove from the alive entities
+        const uint32_t position = entity_positions[index];
+        const EntityID last = alive_entities.back();
+        alive_entities[position] = last;
+        entity_positions[entity_index(last)] = position;
+        alive_entities.pop_back();
+        entity_positions[index] = NO_POSITION;
+
+        // Invalidate every existing ID of this slot. A slot whose generation would wrap is retired.
+        if (entity_generations[index] < std::numeric_limits<EntityGeneration>::max()) {
+            entity_generations[index] += 1;
+            free_entities.push_back(index);
         }
     }
 
-    std::unordered_map<EntityID, std::string> World::get_entities() const { return entities; }
+    std::span<const EntityID> World::get_entities() const { return alive_entities; }
 
     std::vector<std::type_index> World::get_components_of_entity(const EntityID id) const {
         std::vector<std::type_index> res;
 
-        for (const auto &[cpt_type, entity_map]: components) {
-            if (entity_map.contains(id))
-                res.push_back(cpt_type);
+        const ComponentSignature signature = get_signature(id);
+        res.reserve(signature.count());
+        for (TypeId type_id = 0; type_id < components.size(); type_id++) {
+            if (signature.test(type_id) && components[type_id])
+                res.push_back(components[type_id]->get_type());
         }
 
         return res;
     }
 
-    const ResourcePool &World::get_resources() const { return resources; }
+    ResourcePool World::get_resources() const { return resource_registry->get_resources(); }
+
+    size_t World::collect_unused_resources(const std::chrono::microseconds budget) {
+        // Reading the clock for each slot would cost more than scanning it
+        constexpr size_t SLOTS_PER_CLOCK_CHECK = 64;
+
+        const auto start = std::chrono::steady_clock::now();
+        const TypeId type_count = std::min<TypeId>(TypeIdFamily<Resource>::count(), MAX_RESOURCE_TYPES);
 
-    bool World::entity_exists(const EntityID id) const { return entities.contains(id); }
+        size_t slot_count = 0;
+        for (TypeId type_id = 0; type_id < type_count; type_id++)
+            slot_count += get_resource_storage(type_id).get_slot_count();
+
+        size_t destroyed = 0;
+        for (size_t scanned = 0; scanned < slot_count;) {
+            if (collected_type >= type_count) {
+                collected_type = 0;
+                collected_slot = 0;
+            }
+
+            ResourceStorage &storage = get_resource_storage(collected_type);
+            if (collected_slot >= storage.get_slot_count()) {
+                collected_type += 1;
+                collected_slot = 0;
+                continue;
+            }
+
+            // Acquired, as a worker thread may release the resource meanwhile
+            ResourceSlot *slot = storage.acquire_at(collected_slot);
+            collected_slot += 1;
+            scanned += 1;
+
+            // Resources referenced elsewhere than in their pool (by a user, an Rc or as default) are kept.
+            // Releasing the last reference destroys the resource and its GPU objects, and its own resources may
+            // become unused (collected on a next pass)
+            bool destroy = false;
+            if (slot != nullptr) {
+                const Rc<Resource> resource = Rc<Resource>::adopt(slot);
+                destroy = resource_registry->remove_if_unused(*slot);
+                if (destroy)
+                    destroyed += 1;
+            }
+
+            if ((destroy || scanned % SLOTS_PER_CLOCK_CHECK == 0) && std::chrono::steady_clock::now() - start >= budget)
+                break;
+        }
+
+        return destroyed;
+    }
+
+    void World::set_tag(const EntityID id, const TypeId type_id, const bool value) {
+        if (type_id >= MAX_COMPONENT_TYPES)
+            throw std::runtime_error(std::format("Too many component types (maximum is {})", MAX_COMPONENT_TYPES));
+
+        ComponentSignature &signature = entity_signatures[entity_index(id)];
+        if (signature.test(type_id) == value)
+            return;
+
+        signature.set(type_id, value);
+        if (type_id >= tag_changes.size())
+            tag_changes.resize(type_id + 1, 0);
+        tag_changes[type_id] = get_tick();
+    }
+
+    void World::register_query(QueryBase &query) {
+        for (const EntityID id: alive_entities)
+            query.update(id, entity_signatures[entity_index(id)]);
+
+        for (TypeId type_id = 0; type_id < MAX_COMPONENT_TYPES; type_id++) {
+            if (!query.required.test(type_id))
+                continue;
+            if (type_id >= component_queries.size())
+                component_queries.resize(type_id + 1);
+            component_queries[type_id].push_back(&query);
+        }
+    }
+
+    void World::update_queries(const EntityID id, const TypeId type_id) {
+        if (type_id >= component_queries.size())
+            return;
+
+        const ComponentSignature &signature = entity_signatures[entity_index(id)];
+        for (QueryBase *query: component_queries[type_id])
+            query->update(id, signature);
+    }
+
+    Tick World::get_tick() const { return current_tick.load(std::memory_order_relaxed); }
+
+    Tick World::advance_tick() { return current_tick.fetch_add(1, std::memory_order_relaxed); }
+
+    void World::mark_changed(const TypeId type_id, const EntityID id) {
+        if (type_id >= components.size() || !components[type_id])
+            return;
+
+        components[type_id]->mark_changed(id);
+
+        if (has_observers(CHANGE_EVENT, type_id)) {
+            // Components changing during their construction are not attached yet
+            Component *component = components[type_id]->find_component(id);
+            if (component == nullptr)
+                return;
+
+            const std::lock_guard lock(change_observers_mutex);
+            notify(CHANGE_EVENT, type_id, id, *component);
+        }
+    }
+
+    void World::remove_observer(const ObserverID id) {
+        for (auto &event_observers: observers) {
+            for (auto &type_observers: event_observers)
+                std::erase_if(type_observers, [id](const Observer &observer) { return observer.id == id; });
+        }
+    }
+
+    CommandBuffer &World::commands() { return *command_buffer; }
+
+    void World::flush_commands() { command_buffer->flush(); }
+
+    ThreadPool &World::get_thread_pool() { return *thread_pool; }
+
+    ResourceLoader &World::get_loader() { return *resource_loader; }
+
+    FileWatcher &World::get_file_watcher() { return *file_watcher; }
+
+    GpuMemory &World::get_gpu_memory() { return *gpu_memory; }
+
+    Scheduler &World::get_scheduler() { return *scheduler; }
+
+    ResourceStorage &World::get_resource_storage(const TypeId type_id) {
+        return resource_registry->get_storage(type_id);
+    }
+
+    bool World::entity_exists(const EntityID id) const {
+        const EntityIndex index = entity_index(id);
+        return index < entity_generations.size() && entity_positions[index] != NO_POSITION &&
+               entity_generations[index] == entity_generation(id);
+    }
+
+    ComponentSignature World::get_signature(const EntityID id) const {
+        if (!entity_exists(id))
+            return {};
+        return entity_signatures[entity_index(id)];
+    }
 
-    size_t World::generate_random_id() {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<size_t> dis(1, std::numeric_limits<size_t>::max());
-        return dis(gen);
+    bool World::has_component_type(const EntityID id, const TypeId type_id) const {
+        return type_id < MAX_COMPONENT_TYPES && entity_exists(id) && entity_signatures[entity_index(id)].test(type_id);
     }
 } // namespace wrld
@@ -55,7 +55,7 @@ namespace wrld::cpt {
 
     glm::vec3 Camera3D::get_position() const {
         if (const auto transform_cmpnt = world.get_component_opt<Transform>(entity_id)) {
-            return transform_cmpnt.value()->get_position();
+            return transform_cmpnt.value()->get_world_position();
         }
         return glm::vec3(0.0);
     }
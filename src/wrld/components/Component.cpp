@@ -2,24 +2,39 @@
 // Created by leo on 8/11/25.
 //
 
+#include <wrld/World.hpp>
 #include <wrld/components/Component.hpp>
 #include <wrld/resources/Resource.hpp>
 #include <wrld/resources/Rc.hpp>
 
+#include <ranges>
+
 namespace wrld {
-    Component::Component(const EntityID entity_id, World &world) : entity_id(entity_id), world(world) {}
+    Component::Component(const EntityID entity_id, World &world) :
+        entity_id(entity_id), type_id(TypeConstructionScope<Component>::get_current()), world(world) {}
 
     EntityID Component::get_entity() const { return entity_id; }
 
+    TypeId Component::get_type_id() const { return type_id; }
+
+    void Component::mark_changed() const { world.mark_changed(type_id, entity_id); }
+
     bool Component::has_resource(const std::string &unique_name) const {
         return attached_resources.contains(unique_name);
     }
 
+    Component::~Component() {
+        for (const ResourceAttachment &attachment: attached_resources | std::views::values)
+            attachment.resource.detach_user(&attachment.user_position);
+    }
+
     void Component::detach_resource(const std::string &unique_name) {
-        if (!attached_resources.contains(unique_name))
+        const auto it = attached_resources.find(unique_name);
+        if (it == attached_resources.end())
             return;
 
-        attached_resources[unique_name].detach_component_user(std::type_index(typeid(*this)), get_entity());
+        it->second.resource.detach_user(&it->second.user_position);
+        attached_resources.erase(it);
     }
 
     // void Component::detach_resource(const std::string &unique_name) {
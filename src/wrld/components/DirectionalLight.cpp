@@ -11,10 +11,16 @@ namespace wrld::cpt {
 
     glm::vec3 DirectionalLight::get_color() const { return color; }
 
-    void DirectionalLight::set_color(const glm::vec3 &color) { this->color = color; }
+    void DirectionalLight::set_color(const glm::vec3 &color) {
+        this->color = color;
+        mark_changed();
+    }
 
     float DirectionalLight::get_intensity() const { return intensity; }
 
-    void DirectionalLight::set_intensity(const float intensity) { this->intensity = intensity; }
+    void DirectionalLight::set_intensity(const float intensity) {
+        this->intensity = intensity;
+        mark_changed();
+    }
 
 } // namespace wrld::cpt
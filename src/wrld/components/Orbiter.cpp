@@ -10,7 +10,7 @@
 
 namespace wrld::cpt {
     Orbiter::Orbiter(const EntityID entity_id, World &world, const glm::vec3 target, const float distance) :
-        Component(entity_id, world), mode(WORLD_POINT), target_point(std::move(target)), target_entity(0),
+        Component(entity_id, world), mode(WORLD_POINT), target_point(std::move(target)), target_entity(NULL_ENTITY),
         distance(distance), hor_angle(90), vert_angle(20) {}
 
     Orbiter::Orbiter(const EntityID entity_id, World &world, const EntityID target, const float distance) :
@@ -62,7 +62,7 @@ namespace wrld::cpt {
             case ENTITY: {
                 if (const auto transform_opt = world.get_component_opt<Transform>(target_entity);
                     transform_opt.has_value()) {
-                    return transform_opt.value()->get_position() + this->offset;
+                    return transform_opt.value()->get_world_position() + this->offset;
                 }
                 return this->offset;
             }
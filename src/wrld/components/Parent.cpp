@@ -0,0 +1,25 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/components/Parent.hpp>
+
+#include <stdexcept>
+
+namespace wrld::cpt {
+    Parent::Parent(const EntityID entity_id, World &world, const EntityID parent) :
+        Component(entity_id, world), parent(parent) {
+        if (parent == entity_id)
+            throw std::runtime_error("An entity cannot be its own parent");
+    }
+
+    EntityID Parent::get_parent() const { return parent; }
+
+    void Parent::set_parent(const EntityID parent) {
+        if (parent == entity_id)
+            throw std::runtime_error("An entity cannot be its own parent");
+
+        this->parent = parent;
+        mark_changed();
+    }
+} // namespace wrld::cpt
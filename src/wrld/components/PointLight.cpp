@@ -10,9 +10,15 @@ namespace wrld::cpt {
 
     glm::vec3 PointLight::get_color() const { return color; }
 
-    void PointLight::set_color(const glm::vec3 &color) { this->color = color; }
+    void PointLight::set_color(const glm::vec3 &color) {
+        this->color = color;
+        mark_changed();
+    }
 
     float PointLight::get_intensity() const { return intensity; }
 
-    void PointLight::set_intensity(const float intensity) { this->intensity = intensity; }
+    void PointLight::set_intensity(const float intensity) {
+        this->intensity = intensity;
+        mark_changed();
+    }
 } // namespace wrld::cpt
@@ -6,11 +6,15 @@
 
 namespace wrld::cpt {
     StaticModel::StaticModel(const EntityID entity_id, World &world, const Rc<rsc::Model> &model) :
-        Component(entity_id, world) {
+        Component(entity_id, world), model(model) {
         attach_resource("model", model);
     }
 
-    Rc<rsc::Model> StaticModel::get_model() const { return get_resource<rsc::Model>("model"); }
+    const Rc<rsc::Model> &StaticModel::get_model() const { return model; }
 
-    void StaticModel::set_model(const Rc<rsc::Model> &model) { attach_resource("model", model); }
+    void StaticModel::set_model(const Rc<rsc::Model> &model) {
+        attach_resource("model", model);
+        this->model = model;
+        mark_changed();
+    }
 } // namespace wrld::cpt
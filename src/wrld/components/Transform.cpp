@@ -10,7 +10,9 @@
 namespace wrld::cpt {
     Transform::Transform(const EntityID entity_id, World &world, const glm::vec3 &position, const glm::quat &rotation,
                          const glm::vec3 &scale) :
-        Component(entity_id, world), position(position), rotation(rotation), scale(scale) {}
+        Component(entity_id, world), position(position), rotation(rotation), scale(scale) {
+        update();
+    }
 
     glm::vec3 Transform::get_position() const { return position; }
 
@@ -20,25 +22,62 @@ namespace wrld::cpt {
 
     glm::vec3 Transform::get_direction() const { return rotation_matrix() * glm::vec4{0, 0, -1, 0}; }
 
-    void Transform::set_position(const glm::vec3 &position) { this->position = position; }
+    void Transform::set_position(const glm::vec3 &position) {
+        this->position = position;
+        update();
+    }
 
-    void Transform::set_rotation(const glm::quat &rotation) { this->rotation = glm::normalize(rotation); }
+    void Transform::set_rotation(const glm::quat &rotation) {
+        this->rotation = glm::normalize(rotation);
+        update();
+    }
 
-    void Transform::set_scale(const glm::vec3 &scale) { this->scale = scale; }
+    void Transform::set_scale(const glm::vec3 &scale) {
+        this->scale = scale;
+        update();
+    }
 
     void Transform::look_at(const glm::vec3 &target, const glm::vec3 &up) {
-        rotation = glm::quat(glm::inverse(glm::lookAt(position, target, up)));
+        const glm::mat4x4 to_parent = glm::inverse(parent_matrix);
+        look_at_local(glm::vec3(to_parent * glm::vec4(target, 1.0f)), glm::vec3(to_parent * glm::vec4(up, 0.0f)));
     }
 
     void Transform::look_towards(const glm::vec3 &direction, const glm::vec3 &up) {
-        look_at(position + glm::normalize(direction), up);
+        const glm::mat4x4 to_parent = glm::inverse(parent_matrix);
+        const glm::vec3 local_direction = glm::vec3(to_parent * glm::vec4(direction, 0.0f));
+        look_at_local(position + glm::normalize(local_direction), glm::vec3(to_parent * glm::vec4(up, 0.0f)));
+    }
+
+    void Transform::look_at_local(const glm::vec3 &target, const glm::vec3 &up) {
+        rotation = glm::quat(glm::inverse(glm::lookAt(position, target, up)));
+        update();
     }
 
-    glm::mat4x4 Transform::model_matrix() const { return translate_matrix() * rotation_matrix() * scale_matrix(); }
+    glm::vec3 Transform::get_world_position() const { return cached_model_matrix[3]; }
+
+    glm::mat4x4 Transform::model_matrix() const { return cached_model_matrix; }
+
+    glm::mat4x4 Transform::normal_matrix() const { return cached_normal_matrix; }
+
+    glm::mat4x4 Transform::local_matrix() const { return cached_local_matrix; }
 
     glm::mat4x4 Transform::translate_matrix() const { return glm::translate(this->position); }
 
     glm::mat4x4 Transform::rotation_matrix() const { return glm::toMat4(this->rotation); }
 
     glm::mat4x4 Transform::scale_matrix() const { return glm::scale(this->scale); }
+
+    void Transform::set_parent_matrix(const glm::mat4x4 &parent_matrix) {
+        this->parent_matrix = parent_matrix;
+        cached_model_matrix = parent_matrix * cached_local_matrix;
+        cached_normal_matrix = glm::transpose(glm::inverse(cached_model_matrix));
+        mark_changed();
+    }
+
+    void Transform::update() {
+        cached_local_matrix = translate_matrix() * rotation_matrix() * scale_matrix();
+        cached_model_matrix = parent_matrix * cached_local_matrix;
+        cached_normal_matrix = glm::transpose(glm::inverse(cached_model_matrix));
+        mark_changed();
+    }
 } // namespace wrld::cpt
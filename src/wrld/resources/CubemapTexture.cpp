@@ -3,60 +3,103 @@
 //
 
 #include <wrld/resources/CubemapTexture.hpp>
-
-#include "stb_image.hpp"
+#include <wrld/World.hpp>
 
 #include <format>
 #include <ranges>
 
 namespace wrld::rsc {
     CubemapTexture::CubemapTexture(std::string name, World &world /*, Rc<Resource> *rc*/) :
-        Resource(std::move(name), world /*, rc*/), gl_texture(0) {
-        set_texture({"data/textures/lake_cm/right.jpg", "data/textures/lake_cm/left.jpg",
-                     "data/textures/lake_cm/top.jpg", "data/textures/lake_cm/bottom.jpg",
-                     "data/textures/lake_cm/front.jpg", "data/textures/lake_cm/back.jpg"});
-    }
+        Resource(std::move(name), world /*, rc*/), gl_texture(0) {}
 
     CubemapTexture &CubemapTexture::set_texture(const std::vector<std::string> &cubemap_paths) {
-        stbi_set_flip_vertically_on_load(false);
+        watch(cubemap_paths);
+        upload(decode(cubemap_paths));
+        return *this;
+    }
 
-        // Filtering for cubemap
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    CubemapTexture &CubemapTexture::set_texture_async(const std::vector<std::string> &cubemap_paths) {
+        watch(cubemap_paths);
+        world.get_loader().load(get_rc(), [cubemap_paths] {
+            const std::vector<TextureImage> faces = decode(cubemap_paths);
 
-        if (gl_texture == 0) {
-            glGenTextures(1, &gl_texture);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, gl_texture);
-        }
+            size_t bytes = 0;
+            for (const auto &face: faces)
+                bytes += face.size();
 
-        // Load each faces into the glTexture
-        int width, height, nb_channels;
-        for (const auto [i, text_path]: std::ranges::views::enumerate(cubemap_paths)) {
-            unsigned char *data = stbi_load(text_path.c_str(), &width, &height, &nb_channels, 0);
+            return ResourceUpload{[faces](Resource &cubemap) { static_cast<CubemapTexture &>(cubemap).upload(faces); },
+                                  bytes};
+        });
+        return *this;
+    }
 
-            if (data == nullptr) {
-                stbi_image_free(data);
-                throw std::runtime_error(std::format("Error while loading texture {}", text_path));
-            }
+    void CubemapTexture::reload_async() {
+        if (paths.empty())
+            return;
+
+        // Copy, as set_texture_async overwrites it
+        const std::vector<std::string> cubemap_paths = paths;
+        set_texture_async(cubemap_paths);
+    }
 
-            if (nb_channels != 3) {
-                stbi_image_free(data);
+    void CubemapTexture::watch(const std::vector<std::string> &cubemap_paths) {
+        paths = cubemap_paths;
+        for (const auto &path: paths)
+            world.get_file_watcher().watch(path, get_rc());
+    }
+
+    std::vector<TextureImage> CubemapTexture::decode(const std::vector<std::string> &cubemap_paths) {
+        std::vector<TextureImage> faces;
+        faces.reserve(cubemap_paths.size());
+
+        for (const auto &text_path: cubemap_paths) {
+            faces.push_back(Texture::decode(text_path, false));
+            if (faces.back().channels != 3) {
                 throw std::runtime_error("Only RGB images are supported for now");
             }
+        }
 
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE,
-                         data);
+        return faces;
+    }
 
-            stbi_image_free(data);
+    void CubemapTexture::upload(const std::vector<TextureImage> &faces) {
+        if (gl_texture == 0) {
+            glGenTextures(1, &gl_texture);
+        }
+        glBindTexture(GL_TEXTURE_CUBE_MAP, gl_texture);
+
+        // Filtering for cubemap
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+        // Load each faces into the glTexture
+        size_t bytes = 0;
+        for (const auto [i, face]: std::ranges::views::enumerate(faces)) {
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, face.width, face.height, 0, GL_RGB,
+                         GL_UNSIGNED_BYTE, face.pixels.get());
+            bytes += face.size();
         }
         glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 
-        return *this;
+        // The mipmaps add a third of the faces
+        world.get_gpu_memory().track(*this, bytes * 4 / 3);
     }
 
+    bool CubemapTexture::evict_gpu_memory() {
+        // The default cubemap replaces the evicted ones
+        if (is_default() || paths.empty())
+            return false;
+
+        glDeleteTextures(1, &gl_texture);
+        gl_texture = 0;
+        return true;
+    }
+
+    void CubemapTexture::restore_gpu_memory() { reload_async(); }
+
     // CubemapTexture::CubemapTexture(CubemapTexture &&other) noexcept : gl_texture(other.gl_texture) {
     //     other.gl_texture = 0;
     // }
@@ -72,9 +115,29 @@ namespace wrld::rsc {
     // }
 
     void CubemapTexture::use(const unsigned unit) const {
+        world.get_gpu_memory().touch(*this);
+
+        if (gl_texture == 0) {
+            // Not loaded yet, or evicted: the default cubemap is used instead, and loaded on its first use
+            const Rc<CubemapTexture> default_cubemap = world.get_default<CubemapTexture>();
+            if (default_cubemap.get() != this) {
+                default_cubemap->use(unit);
+                return;
+            }
+
+            default_cubemap.get_mut()->set_texture(
+                    {"data/textures/lake_cm/right.jpg", "data/textures/lake_cm/left.jpg",
+                     "data/textures/lake_cm/top.jpg", "data/textures/lake_cm/bottom.jpg",
+                     "data/textures/lake_cm/front.jpg", "data/textures/lake_cm/back.jpg"});
+        }
+
         glActiveTexture(GL_TEXTURE0 + unit);
         glBindTexture(GL_TEXTURE_CUBE_MAP, gl_texture);
     }
 
-    CubemapTexture::~CubemapTexture() { glDeleteTextures(1, &gl_texture); }
+    CubemapTexture::~CubemapTexture() {
+        // Cubemaps never uploaded may be destroyed by any thread
+        if (gl_texture != 0)
+            glDeleteTextures(1, &gl_texture);
+    }
 } // namespace wrld::rsc
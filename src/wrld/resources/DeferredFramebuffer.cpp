@@ -4,6 +4,7 @@
 
 #include <wrld/resources/DeferredFramebuffer.hpp>
 #include <wrld/resources/Framebuffer.hpp>
+#include <wrld/World.hpp>
 
 #include <format>
 
@@ -44,13 +45,13 @@ namespace wrld::rsc {
             glDeleteFramebuffers(1, &fbo);
         }
         if (position_texture != 0) {
-            glDeleteTextures(1, &depth_texture);
+            glDeleteTextures(1, &position_texture);
         }
         if (normal_texture != 0) {
-            glDeleteTextures(1, &depth_texture);
+            glDeleteTextures(1, &normal_texture);
         }
         if (diffuse_texture != 0) {
-            glDeleteTextures(1, &depth_texture);
+            glDeleteTextures(1, &diffuse_texture);
         }
         if (depth_texture != 0) {
             glDeleteTextures(1, &depth_texture);
@@ -102,6 +103,9 @@ namespace wrld::rsc {
         constexpr GLenum buffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
         glDrawBuffers(3, buffers);
 
+        // RGB16F positions, RGB8 normals, RGBA diffuse and depth, which must stay on the GPU
+        world.get_gpu_memory().track(*this, static_cast<size_t>(width) * height * (6 + 3 + 4 + 4), false);
+
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     }
 
@@ -0,0 +1,190 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/resources/FileWatcher.hpp>
+
+#include <wrld/World.hpp>
+#include <wrld/logs.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <ranges>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace wrld {
+    FileWatcher::FileWatcher(World &world) : world(world) {}
+
+    FileWatcher::~FileWatcher() {
+#ifdef __linux__
+        if (inotify_fd >= 0)
+            close(inotify_fd);
+#endif
+    }
+
+    void FileWatcher::set_enabled(const bool enabled) {
+        const std::lock_guard lock(mutex);
+        if (enabled == this->enabled.load(std::memory_order_relaxed))
+            return;
+
+#ifdef __linux__
+        if (enabled) {
+            inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (inotify_fd < 0) {
+                throw std::runtime_error(std::format("Unable to watch files: {}", std::strerror(errno)));
+            }
+
+            for (const auto &directory: directories | std::views::keys)
+                watch_directory(directory);
+        } else {
+            // Closing the instance removes all its watches
+            close(inotify_fd);
+            inotify_fd = -1;
+            watch_directories.clear();
+        }
+        this->enabled.store(enabled, std::memory_order_release);
+#else
+        throw std::runtime_error("File watching is only supported on Linux");
+#endif
+    }
+
+    bool FileWatcher::is_enabled() const { return enabled.load(std::memory_order_acquire); }
+
+    void FileWatcher::watch(const std::string &path, const Rc<Resource> &resource) {
+        // Resources outside of any storage have no handle to be found back with
+        if (resource.get() == nullptr)
+            return;
+
+        const std::filesystem::path file = std::filesystem::absolute(path).lexically_normal();
+        const std::string directory = file.parent_path().string();
+
+        const std::lock_guard lock(mutex);
+        const bool new_directory = !directories.contains(directory);
+        auto &watches = directories[directory][file.filename().string()];
+
+        const Watch watch{resource->get_type_id(), resource.get_handle()};
+        if (std::ranges::find(watches, watch) == watches.end())
+            watches.push_back(watch);
+
+        if (new_directory && inotify_fd >= 0)
+            watch_directory(directory);
+    }
+
+    size_t FileWatcher::poll() {
+#ifdef __linux__
+        if (!is_enabled())
+            return 0;
+
+        std::vector<Rc<Resource>> changed;
+        // Resources checked while pruning, released after unlocking as this may destroy them
+        std::vector<Rc<Resource>> acquired;
+        // Released before reloading, which may watch files
+        std::unique_lock lock(mutex);
+        if (inotify_fd < 0)
+            return 0;
+
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        // Non-blocking: stops once every pending event is read
+        while ((length = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+            for (const char *ptr = buffer; ptr < buffer + length;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    wrldError("Too many file changes at once, some resources may not be reloaded");
+                    continue;
+                }
+
+                const auto directory = watch_directories.find(event->wd);
+                if (directory == watch_directories.end())
+                    continue;
+
+                // The directory was deleted or moved
+                if (event->mask & IN_IGNORED) {
+                    watch_directories.erase(directory);
+                    continue;
+                }
+
+                auto &files = directories.at(directory->second);
+                const auto file = files.find(event->name);
+                if (event->len == 0 || file == files.end())
+                    continue;
+
+                // Watches of destroyed resources are dropped when their file changes, or by prune
+                std::erase_if(file->second, [&](const Watch &watch) {
+                    ResourceSlot *slot = world.get_resource_storage(watch.type_id).acquire(watch.handle);
+                    if (slot == nullptr)
+                        return true;
+
+                    Rc<Resource> resource = Rc<Resource>::adopt(slot);
+                    if (std::ranges::find(changed, resource) == changed.end())
+                        changed.push_back(std::move(resource));
+                    return false;
+                });
+            }
+        }
+
+        polls_since_prune += 1;
+        if (polls_since_prune >= PRUNE_INTERVAL) {
+            polls_since_prune = 0;
+            prune(acquired);
+        }
+
+        lock.unlock();
+        acquired.clear();
+
+        for (const auto &resource: changed) {
+            wrldInfo(std::format("Reloading {}", resource->get_name()));
+            try {
+                resource.get_mut()->reload_async();
+            } catch (const std::exception &e) {
+                wrldError(std::format("Unable to reload {}: {}", resource->get_name(), e.what()));
+            }
+        }
+
+        return changed.size();
+#else
+        return 0;
+#endif
+    }
+
+    void FileWatcher::watch_directory(const std::string &directory) {
+#ifdef __linux__
+        // Written files, and files replaced by renaming another one
+        const int wd = inotify_add_watch(inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            wrldError(std::format("Unable to watch {}: {}", directory, std::strerror(errno)));
+            return;
+        }
+
+        watch_directories.insert_or_assign(wd, directory);
+#endif
+    }
+
+    void FileWatcher::prune(std::vector<Rc<Resource>> &acquired) {
+        // Directories are kept, as their inotify watches refer to them
+        for (auto &files: directories | std::views::values) {
+            for (auto file = files.begin(); file != files.end();) {
+                std::erase_if(file->second, [&](const Watch &watch) {
+                    ResourceSlot *slot = world.get_resource_storage(watch.type_id).acquire(watch.handle);
+                    if (slot == nullptr)
+                        return true;
+
+                    acquired.push_back(Rc<Resource>::adopt(slot));
+                    return false;
+                });
+                file = file->second.empty() ? files.erase(file) : std::next(file);
+            }
+        }
+    }
+} // namespace wrld
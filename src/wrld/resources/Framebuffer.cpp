@@ -3,6 +3,7 @@
 //
 
 #include <wrld/resources/Framebuffer.hpp>
+#include <wrld/World.hpp>
 
 #include <format>
 
@@ -87,6 +88,9 @@ namespace wrld::rsc {
         glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT,
                      nullptr);
 
+        // RGBA color attachments and depth, which must stay on the GPU
+        const size_t bytes = static_cast<size_t>(width) * height * 4 * (nb_color_attachments + 1);
+        world.get_gpu_memory().track(*this, bytes, false);
 
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
     }
@@ -0,0 +1,135 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/resources/GpuMemory.hpp>
+
+#include <wrld/resources/Resource.hpp>
+
+namespace wrld {
+    void GpuMemory::set_budget(const size_t bytes) { budget = bytes; }
+
+    size_t GpuMemory::get_budget() const { return budget; }
+
+    void GpuMemory::set_eviction_delay(const uint64_t frames) { eviction_delay = frames; }
+
+    size_t GpuMemory::get_used() const { return used; }
+
+    void GpuMemory::track(Resource &resource, const size_t bytes, const bool evictable) {
+        if (resource.gpu_entry == NO_ENTRY) {
+            if (free_entries.empty()) {
+                resource.gpu_entry = static_cast<uint32_t>(entries.size());
+                entries.emplace_back();
+            } else {
+                resource.gpu_entry = free_entries.back();
+                free_entries.pop_back();
+            }
+            entries[resource.gpu_entry].resource = &resource;
+        }
+
+        const uint32_t index = resource.gpu_entry;
+        if (entries[index].linked)
+            unlink(index);
+
+        Entry &entry = entries[index];
+        used = used - entry.bytes + bytes;
+        entry.bytes = bytes;
+        entry.evictable = evictable;
+        entry.evicted = false;
+        entry.last_use = frame;
+
+        if (evictable && bytes > 0)
+            link(index);
+    }
+
+    void GpuMemory::untrack(Resource &resource) {
+        const uint32_t index = resource.gpu_entry;
+        if (index == NO_ENTRY)
+            return;
+
+        if (entries[index].linked)
+            unlink(index);
+
+        used -= entries[index].bytes;
+        entries[index] = Entry();
+        free_entries.push_back(index);
+        resource.gpu_entry = NO_ENTRY;
+    }
+
+    void GpuMemory::touch(const Resource &resource) {
+        const uint32_t index = resource.gpu_entry;
+        if (index == NO_ENTRY)
+            return;
+
+        Entry &entry = entries[index];
+        if (entry.last_use == frame)
+            return;
+        entry.last_use = frame;
+
+        if (entry.linked) {
+            // Move to the most recently used end
+            unlink(index);
+            link(index);
+        } else if (entry.evicted) {
+            entry.evicted = false;
+            // Tracks the resource again once uploaded, which may reallocate the entries
+            entry.resource->restore_gpu_memory();
+        }
+    }
+
+    size_t GpuMemory::evict() {
+        size_t evicted = 0;
+
+        // Stop at the first entry used too recently: the next ones were used later
+        while (budget > 0 && used > budget && first != NO_ENTRY && frame - entries[first].last_use > eviction_delay) {
+            const uint32_t index = first;
+            unlink(index);
+
+            if (!entries[index].resource->evict_gpu_memory()) {
+                // Considered used, to look at the next entries
+                entries[index].last_use = frame;
+                link(index);
+                continue;
+            }
+
+            used -= entries[index].bytes;
+            entries[index].bytes = 0;
+            entries[index].evicted = true;
+            evicted += 1;
+        }
+
+        frame += 1;
+        return evicted;
+    }
+
+    void GpuMemory::link(const uint32_t index) {
+        Entry &entry = entries[index];
+        entry.previous = last;
+        entry.next = NO_ENTRY;
+        entry.linked = true;
+
+        if (last == NO_ENTRY)
+            first = index;
+        else
+            entries[last].next = index;
+        last = index;
+    }
+
+    void GpuMemory::unlink(const uint32_t index) {
+        Entry &entry = entries[index];
+
+        if (entry.previous == NO_ENTRY)
+            first = entry.next;
+        else
+            entries[entry.previous].next = entry.next;
+
+        if (entry.next == NO_ENTRY)
+            last = entry.previous;
+        else
+            entries[entry.next].previous = entry.previous;
+
+        entry.previous = NO_ENTRY;
+        entry.next = NO_ENTRY;
+        entry.linked = false;
+    }
+} // namespace wrld
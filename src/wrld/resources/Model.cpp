@@ -15,7 +15,7 @@
 #include <utility>
 
 namespace wrld::rsc {
-    std::vector<glm::vec3> BoundingBox::vertices() const {
+    std::array<glm::vec3, 8> BoundingBox::vertices() const {
         /*   6           upper
          *      +---------+
          *     /|        /|
@@ -27,7 +27,7 @@ namespace wrld::rsc {
          *   +---------+                 +--- x
          * lower        1
          */
-        std::vector<glm::vec3> res(8);
+        std::array<glm::vec3, 8> res;
         res[0] = lower;
         res[1] = {upper.x, lower.y, lower.z};
         res[2] = {lower.x, lower.y, upper.z};
@@ -61,9 +61,174 @@ namespace wrld::rsc {
         return *this;
     }
 
+    class Model::SceneBuilder {
+    public:
+        /// Textures are loaded with Texture::set_texture_async if async_textures is set, with set_texture otherwise.
+        SceneBuilder(World &world, std::string model_directory, const bool flip_textures,
+                     std::optional<Rc<Material>> custom_material, const bool async_textures) :
+            world(world), model_directory(std::move(model_directory)), flip_textures(flip_textures),
+            custom_material(std::move(custom_material)), async_textures(async_textures) {}
+
+        /// Create the materials, textures and meshes of the scene, then aggregate them. Uses no OpenGL: it may be
+        /// called from a worker thread, the resources it creates only being used by it until it returns.
+        [[nodiscard]] Scene build(const aiScene *scene) const {
+            Scene res;
+            if (!custom_material.has_value()) {
+                res.materials = load_materials(scene, res);
+            } else {
+                res.materials.push_back(custom_material.value());
+            }
+
+            res.root_mesh = process_node(scene->mRootNode, scene, res);
+            res.geometry = aggregate_meshes(res.meshes);
+            return res;
+        }
+
+    private:
+        World &world;
+        std::string model_directory;
+        bool flip_textures;
+        std::optional<Rc<Material>> custom_material;
+        bool async_textures;
+
+        std::vector<Rc<Material>> load_materials(const aiScene *scene, Scene &res) const {
+            std::vector<Rc<Material>> materials;
+            materials.reserve(scene->mNumMaterials);
+
+            for (int i = 0; i < scene->mNumMaterials; i++) {
+                // todo: load more data from the material
+
+                // Create the material
+                const aiMaterial *ai_material = scene->mMaterials[i];
+                auto material = world.create_resource<Material>(ai_material->GetName().C_Str());
+
+                // Load the textures
+                const auto diffuse_textures = load_textures(ai_material, aiTextureType_DIFFUSE, scene, res, 1);
+                const auto specular_textures = load_textures(ai_material, aiTextureType_SPECULAR, scene, res, 1);
+
+                if (!diffuse_textures.empty())
+                    material.get_mut()->set_diffuse_map(diffuse_textures[0]);
+                if (!specular_textures.empty())
+                    material.get_mut()->set_specular_map(specular_textures[0]);
+
+                materials.push_back(material);
+            }
+
+            return materials;
+        }
+
+        std::shared_ptr<MeshGraphNode> process_node(const aiNode *node, const aiScene *scene, Scene &res) const {
+            auto wrld_node = std::make_shared<MeshGraphNode>();
+
+            // One node can contain multiple meshes
+            for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+                const aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
+                const auto &new_mesh = process_mesh(mesh, res);
+                res.meshes.push_back(new_mesh);
+                wrld_node->meshes.push_back(new_mesh);
+            }
+
+            // One node can have multiple children
+            for (unsigned int i = 0; i < node->mNumChildren; i++) {
+                wrld_node->children.push_back(process_node(node->mChildren[i], scene, res));
+            }
+
+            return wrld_node;
+        }
+
+        Rc<Mesh> process_mesh(const aiMesh *mesh, const Scene &res) const {
+            auto new_mesh = world.create_resource<Mesh>(mesh->mName.C_Str());
+            if (custom_material.has_value()) {
+                new_mesh.get_mut()->set_material(custom_material.value());
+            } else {
+                new_mesh.get_mut()->set_material(res.materials[mesh->mMaterialIndex]);
+            }
+
+            // Process vertices
+            for (unsigned i = 0; i < mesh->mNumVertices; i++) {
+                Vertex vertex;
+
+                const aiVector3D &vertex_pos = mesh->mVertices[i];
+                const aiVector3D &vertex_normal = mesh->mNormals[i];
+                const aiVector3D &vertex_texcoords =
+                        mesh->mTextureCoords[0] ? mesh->mTextureCoords[0][i] : aiVector3D{0, 0, 0};
+                const aiColor4D &vertex_color =
+                        mesh->mColors[0] ? mesh->mColors[0][i] : aiColor4D{1.0, 1.0, 1.0, 1.0};
+
+                vertex.position = {vertex_pos.x, vertex_pos.y, vertex_pos.z};
+                vertex.normal = {vertex_normal.x, vertex_normal.y, vertex_normal.z};
+                vertex.color = {vertex_color.r, vertex_color.g, vertex_color.b};
+                vertex.texcoords = {vertex_texcoords.x, vertex_texcoords.y};
+
+                new_mesh.get_mut()->add_vertex(vertex);
+            }
+
+            // Indices
+            for (unsigned i = 0; i < mesh->mNumFaces; i++) {
+                const aiFace &face = mesh->mFaces[i];
+                for (unsigned j = 0; j < face.mNumIndices; j++) {
+                    new_mesh.get_mut()->add_element(face.mIndices[j]);
+                }
+            }
+
+            return new_mesh;
+        }
+
+        /// Load textures of the given type from aiMaterial.
+        /// Will only return a maximum of max textures.
+        std::vector<Rc<Texture>> load_textures(const aiMaterial *material, const aiTextureType type,
+                                               const aiScene *scene, Scene &res, const unsigned max = 1) const {
+            const unsigned count = std::min(material->GetTextureCount(type), max);
+
+            std::vector<Rc<Texture>> textures;
+            textures.reserve(count);
+
+            for (unsigned i = 0; i < count; i++) {
+                // str can either be an embedded texture OR an external texture that will be loaded from filesystem
+                aiString str;
+                material->GetTexture(type, i, &str);
+
+                // Case of an embedded file
+                if (scene->GetEmbeddedTexture(str.C_Str())) {
+                    throw std::runtime_error("Embedded textures are not supported yet");
+                }
+
+                // Case of an external file
+                const std::string texture_path = std::format("{}/{}", model_directory, str.C_Str());
+
+                // If it was already loaded, just return the cached structure
+                if (res.textures.contains(texture_path)) {
+                    textures.push_back(res.textures.at(texture_path));
+                    continue;
+                }
+
+                // If not, load the texture to GPU, add it to cache and return
+                auto texture = world.create_resource<Texture>(str.C_Str());
+                if (async_textures)
+                    texture.get_mut()->set_texture_async(texture_path, type, flip_textures);
+                else
+                    texture.get_mut()->set_texture(texture_path, type, flip_textures);
+                res.textures.insert_or_assign(texture_path, texture);
+                textures.push_back(texture);
+            }
+
+            return textures;
+        }
+    };
+
     Model::Model(std::string name, World &world) :
         Resource(std::move(name), world), mesh_count(0), vao(0), vbo(0), ebo(0), ai_flags(0), flip_textures(false) {}
 
+    Model::~Model() {
+        // Models never uploaded may be destroyed by any thread
+        if (vao == 0)
+            return;
+
+        glDeleteBuffers(1, &ebo);
+        glDeleteBuffers(1, &vbo);
+        glDeleteVertexArrays(1, &vao);
+    }
+
     Model &Model::from_file(const std::string &model_path, const unsigned ai_flags, const bool flip_textures,
                             const std::optional<Rc<Material>> &custom_material) {
         this->model_path = model_path;
@@ -71,13 +236,53 @@ namespace wrld::rsc {
         this->ai_flags = ai_flags;
         this->flip_textures = flip_textures;
         this->custom_material = custom_material;
+        world.get_file_watcher().watch(model_path, get_rc());
 
         reload_from_file();
-        aggregate();
         return *this;
     }
 
+    Model &Model::from_file_async(const std::string &model_path, const unsigned ai_flags, const bool flip_textures,
+                                  const std::optional<Rc<Material>> &custom_material) {
+        this->model_path = model_path;
+        model_directory = model_path.substr(0, model_path.find_last_of('/'));
+        this->ai_flags = ai_flags;
+        this->flip_textures = flip_textures;
+        this->custom_material = custom_material;
+        world.get_file_watcher().watch(model_path, get_rc());
+
+        wrldInfo(std::format("Loading model {} in background", model_path).c_str());
+        const SceneBuilder builder(world, model_directory, flip_textures, custom_material, true);
+        world.get_loader().load(get_rc(), [model_path, ai_flags, builder] {
+            // Only the GPU upload is left to the main thread: the meshes, materials and aggregated geometry are
+            // built here, the importer and its scene are released before returning
+            std::shared_ptr<Scene> scene;
+            {
+                Assimp::Importer importer;
+                scene = std::make_shared<Scene>(builder.build(read_scene(importer, model_path, ai_flags)));
+            }
+
+            const size_t bytes = scene->geometry.vertices.size() * sizeof(Vertex) +
+                                 scene->geometry.elements.size() * sizeof(VertexID);
+            return ResourceUpload{
+                    [scene](Resource &model) { static_cast<Model &>(model).set_scene(std::move(*scene)); }, bytes};
+        });
+        return *this;
+    }
+
+    void Model::reload_async() {
+        if (model_path.empty())
+            return;
+
+        // Copies, as from_file_async overwrites them
+        const std::string path = model_path;
+        const std::optional<Rc<Material>> material = custom_material;
+        from_file_async(path, ai_flags, flip_textures, material);
+    }
+
     Model &Model::from_mesh(const Rc<Mesh> &mesh) {
+        // Not loaded from a file anymore (see reload_async)
+        model_path.clear();
         meshes.clear();
         root_mesh = std::make_shared<MeshGraphNode>();
         root_mesh->meshes.push_back(mesh);
@@ -92,40 +297,81 @@ namespace wrld::rsc {
         return *this;
     }
 
+    Model &Model::from_geometry(const std::span<const Vertex> vertices, const std::span<const VertexID> elements,
+                                const std::span<const uint64_t> meshes_start,
+                                const std::span<const uint64_t> meshes_size,
+                                const std::span<const uint32_t> mesh_materials,
+                                const std::vector<Rc<Material>> &materials) {
+        if (meshes_size.size() != meshes_start.size() || mesh_materials.size() != meshes_start.size()) {
+            throw std::runtime_error(std::format("Model `{}`: inconsistent mesh ranges", get_name()));
+        }
+
+        model_path.clear();
+        meshes.clear();
+        root_mesh = std::make_shared<MeshGraphNode>();
+        mesh_count = meshes_start.size();
+        loaded_materials = materials;
+
+        // Bulk copies, no per-vertex processing
+        this->vertices.assign(vertices.begin(), vertices.end());
+        this->elements.assign(elements.begin(), elements.end());
+        this->meshes_start.assign(meshes_start.begin(), meshes_start.end());
+        this->meshes_size.assign(meshes_size.begin(), meshes_size.end());
+
+        material_meshes.clear();
+        for (const auto &mat: materials) {
+            material_meshes.try_emplace(mat.get_ref().get_name());
+        }
+        for (const auto &[i, mat]: mesh_materials | std::views::enumerate) {
+            if (mat >= materials.size()) {
+                throw std::runtime_error(std::format("Model `{}`: mesh {} has no material", get_name(), i));
+            }
+            material_meshes.at(materials[mat].get_ref().get_name()).push_back(i);
+        }
+
+        upload();
+        this->local_bb = compute_local_bb(this->vertices);
+        return *this;
+    }
+
     void Model::reload_from_file() {
         wrldInfo(std::format("Loading model {}", model_path).c_str());
 
         Assimp::Importer import;
-        const aiScene *scene = import.ReadFile(model_path, ai_flags);
+        const SceneBuilder builder(world, model_directory, flip_textures, custom_material, false);
+        set_scene(builder.build(read_scene(import, model_path, ai_flags)));
+    }
+
+    const aiScene *Model::read_scene(Assimp::Importer &importer, const std::string &model_path,
+                                     const unsigned ai_flags) {
+        const aiScene *scene = importer.ReadFile(model_path, ai_flags);
         if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            throw std::runtime_error(std::format("Unable to load model `{}`: {}", model_path, import.GetErrorString()));
+            throw std::runtime_error(
+                    std::format("Unable to load model `{}`: {}", model_path, importer.GetErrorString()));
         }
         if (scene->mNumMeshes == 0) {
             throw std::runtime_error(std::format("Model `{}` has no meshes", model_path));
         }
+        return scene;
+    }
 
-        loaded_materials.clear();
-        if (!custom_material.has_value()) {
-            loaded_materials = load_materials(scene);
-        } else {
-            loaded_materials.push_back(custom_material.value());
-        }
-
-        meshes.clear();
-        root_mesh = process_node(scene->mRootNode, scene);
+    void Model::set_scene(Scene &&scene) {
+        root_mesh = std::move(scene.root_mesh);
+        meshes = std::move(scene.meshes);
+        mesh_count = meshes.size();
+        loaded_materials = std::move(scene.materials);
+        loaded_textures = std::move(scene.textures);
+        set_geometry(std::move(scene.geometry));
     }
 
-    void Model::aggregate() {
-        vertices.clear();
-        elements.clear();
-        meshes_start.clear();
-        meshes_size.clear();
-        // primitive_types.clear();
-        material_meshes.clear();
+    void Model::aggregate() { set_geometry(aggregate_meshes(meshes)); }
+
+    Model::Geometry Model::aggregate_meshes(const std::vector<Rc<Mesh>> &meshes) {
+        Geometry res;
 
         // Pre-allocate vectors
-        meshes_start.reserve(meshes.size());
-        meshes_size.reserve(meshes.size());
+        res.meshes_start.reserve(meshes.size());
+        res.meshes_size.reserve(meshes.size());
         // primitive_types.reserve(meshes.size());
 
         size_t total_vertex_size = 0;
@@ -135,31 +381,43 @@ namespace wrld::rsc {
             total_element_size += m.get_ref().indices.size();
 
             const auto &mat = m.get_ref().get_material().get_ref();
-            if (!material_meshes.contains(mat.get_name())) {
-                material_meshes.insert_or_assign(mat.get_name(), std::vector<unsigned>());
-            }
-
-            material_meshes.at(mat.get_name()).push_back(i);
+            res.material_meshes[mat.get_name()].push_back(i);
         }
 
-        vertices.reserve(total_vertex_size);
-        elements.reserve(total_element_size);
+        res.vertices.reserve(total_vertex_size);
+        res.elements.reserve(total_element_size);
 
         // Aggregate
         for (const auto &m: meshes) {
             const auto &mesh = m.get_ref();
 
-            meshes_start.push_back(elements.size());
-            meshes_size.push_back(mesh.indices.size());
+            res.meshes_start.push_back(res.elements.size());
+            res.meshes_size.push_back(mesh.indices.size());
             // primitive_types.push_back(mesh.get_gl_primitive_type());
 
             for (const auto &e: mesh.indices) {
-                elements.push_back(e + vertices.size());
+                res.elements.push_back(e + res.vertices.size());
             }
 
-            vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+            res.vertices.insert(res.vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
         }
 
+        res.local_bb = compute_local_bb(res.vertices);
+        return res;
+    }
+
+    void Model::set_geometry(Geometry &&geometry) {
+        vertices = std::move(geometry.vertices);
+        elements = std::move(geometry.elements);
+        meshes_start = std::move(geometry.meshes_start);
+        meshes_size = std::move(geometry.meshes_size);
+        material_meshes = std::move(geometry.material_meshes);
+        local_bb = geometry.local_bb;
+
+        upload();
+    }
+
+    void Model::upload() {
         // Update VAO/VBO/EBO
         if (vao == 0)
             glGenVertexArrays(1, &vao);
@@ -196,11 +454,25 @@ namespace wrld::rsc {
                               reinterpret_cast<void *>(offsetof(Vertex, texcoords)));
         glBindVertexArray(0);
 
-        // Update bounding box
-        this->local_bb = compute_local_bb();
+        world.get_gpu_memory().track(*this, vertices.size() * sizeof(Vertex) + elements.size() * sizeof(VertexID));
+    }
+
+    bool Model::evict_gpu_memory() {
+        if (is_default())
+            return false;
+
+        glDeleteBuffers(1, &ebo);
+        glDeleteBuffers(1, &vbo);
+        glDeleteVertexArrays(1, &vao);
+        ebo = 0;
+        vbo = 0;
+        vao = 0;
+        return true;
     }
 
-    BoundingBox Model::compute_local_bb() const {
+    void Model::restore_gpu_memory() { upload(); }
+
+    BoundingBox Model::compute_local_bb(const std::span<const Vertex> vertices) {
         BoundingBox res = {glm::vec3(0), glm::vec3(0)};
 
         for (const auto &v: vertices) {
@@ -222,32 +494,6 @@ namespace wrld::rsc {
         return res;
     }
 
-    std::vector<Rc<Material>> Model::load_materials(const aiScene *scene) {
-        std::vector<Rc<Material>> res;
-        res.reserve(scene->mNumMaterials);
-
-        for (int i = 0; i < scene->mNumMaterials; i++) {
-            // todo: load more data from the material
-
-            // Create the material
-            const aiMaterial *ai_material = scene->mMaterials[i];
-            auto material = world.create_resource<Material>(ai_material->GetName().C_Str());
-
-            // Load the textures
-            const auto diffuse_textures = load_textures(ai_material, aiTextureType_DIFFUSE, scene, flip_textures, 1);
-            const auto specular_textures = load_textures(ai_material, aiTextureType_SPECULAR, scene, flip_textures, 1);
-
-            if (!diffuse_textures.empty())
-                material.get_mut()->set_diffuse_map(diffuse_textures[0]);
-            if (!specular_textures.empty())
-                material.get_mut()->set_specular_map(specular_textures[0]);
-
-            res.push_back(material);
-        }
-
-        return res;
-    }
-
     size_t Model::get_mesh_count() const { return mesh_count; }
 
     const std::shared_ptr<MeshGraphNode> &Model::get_root_mesh() const { return root_mesh; }
@@ -273,101 +519,4 @@ namespace wrld::rsc {
     GLuint Model::get_vao() const { return vao; }
 
     const std::vector<Rc<Mesh>> &Model::get_meshes() const { return meshes; }
-
-    std::shared_ptr<MeshGraphNode> Model::process_node(const aiNode *node, const aiScene *scene) {
-        auto wrld_node = std::make_shared<MeshGraphNode>();
-
-        // One node can contain multiple meshes
-        for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-            const aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-            const auto &new_mesh = process_mesh(mesh);
-            meshes.push_back(new_mesh);
-            wrld_node->meshes.push_back(new_mesh);
-        }
-
-        // One node can have multiple children
-        for (unsigned int i = 0; i < node->mNumChildren; i++) {
-            wrld_node->children.push_back(process_node(node->mChildren[i], scene));
-        }
-
-        return wrld_node;
-    }
-
-    Rc<Mesh> Model::process_mesh(const aiMesh *mesh) {
-        auto new_mesh = world.create_resource<Mesh>(mesh->mName.C_Str());
-        if (custom_material.has_value()) {
-            new_mesh.get_mut()->set_material(custom_material.value());
-        } else {
-            new_mesh.get_mut()->set_material(loaded_materials[mesh->mMaterialIndex]);
-        }
-
-        // Process vertices
-        for (unsigned i = 0; i < mesh->mNumVertices; i++) {
-            Vertex vertex;
-
-            const aiVector3D &vertex_pos = mesh->mVertices[i];
-            const aiVector3D &vertex_normal = mesh->mNormals[i];
-            const aiVector3D &vertex_texcoords =
-                    mesh->mTextureCoords[0] ? mesh->mTextureCoords[0][i] : aiVector3D{0, 0, 0};
-            const aiColor4D &vertex_color = mesh->mColors[0] ? mesh->mColors[0][i] : aiColor4D{1.0, 1.0, 1.0, 1.0};
-
-            vertex.position = {vertex_pos.x, vertex_pos.y, vertex_pos.z};
-            vertex.normal = {vertex_normal.x, vertex_normal.y, vertex_normal.z};
-            vertex.color = {vertex_color.r, vertex_color.g, vertex_color.b};
-            vertex.texcoords = {vertex_texcoords.x, vertex_texcoords.y};
-
-            new_mesh.get_mut()->add_vertex(vertex);
-        }
-
-        // Indices
-        for (unsigned i = 0; i < mesh->mNumFaces; i++) {
-            const aiFace &face = mesh->mFaces[i];
-            for (unsigned j = 0; j < face.mNumIndices; j++) {
-                new_mesh.get_mut()->add_element(face.mIndices[j]);
-            }
-        }
-
-        mesh_count += 1;
-
-        // new_mesh.get_mut()->update();
-        return new_mesh;
-    }
-
-    std::vector<Rc<Texture>> Model::load_textures(const aiMaterial *material, const aiTextureType type,
-                                                  const aiScene *scene, const bool flip_textures, const unsigned max) {
-        const unsigned count = std::min(material->GetTextureCount(type), max);
-
-        std::vector<Rc<Texture>> res;
-        res.reserve(count);
-
-        for (unsigned i = 0; i < count; i++) {
-            // str can either be an embedded texture OR an external texture that will be loaded from filesystem
-            aiString str;
-            material->GetTexture(type, i, &str);
-
-            // Case of an embedded file
-            if (scene->GetEmbeddedTexture(str.C_Str())) {
-                throw std::runtime_error("Embedded textures are not supported yet");
-            }
-
-            // Case of an external file
-            const std::string texture_path = std::format("{}/{}", model_directory, str.C_Str());
-
-            // If it was already loaded, just return the cached structure
-            if (loaded_textures.contains(texture_path)) {
-                res.push_back(loaded_textures.at(texture_path));
-                continue;
-            }
-
-            // If not, load the texture to GPU, add it to cache and return
-            auto texture = world.create_resource<Texture>(str.C_Str());
-            texture.get_mut()->set_texture(texture_path, type, flip_textures);
-            loaded_textures.insert_or_assign(texture_path, texture);
-            res.push_back(texture);
-        }
-
-        return res;
-    }
-
-
 } // namespace wrld::rsc
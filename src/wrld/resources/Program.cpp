@@ -6,6 +6,7 @@
 #include <wrld/shaders/vertex/default_shader.hpp>
 #include <wrld/shaders/fragment/default_shader.hpp>
 
+#include <wrld/World.hpp>
 #include <wrld/resources/Rc.hpp>
 #include <wrld/logs.hpp>
 
@@ -28,15 +29,14 @@ namespace wrld::rsc {
         }
     }
 
-    // Just a way to use a 2-in-1 shader file without specifying the same path twice.
+    // Compiled from the default sources on first use (see use), so that programs can be created by any thread.
     Program::Program(std::string name, World &world /*, Rc<Resource> *rc*/) :
-        Resource(std::move(name), world /*, rc*/) {
-        reload_from_source(shader::DEFAULT_VERTEX, shader::DEFAULT_FRAGMENT);
-    }
+        Resource(std::move(name), world /*, rc*/) {}
 
     Program &Program::from_file(const std::string &combined_shader_path) {
         this->vertex_shader_path = combined_shader_path;
         this->fragment_shader_path = combined_shader_path;
+        world.get_file_watcher().watch(combined_shader_path, get_rc());
         reload_from_file();
         return *this;
     }
@@ -44,16 +44,31 @@ namespace wrld::rsc {
     Program &Program::from_file(const std::string &vertex_path, const std::string &fragment_path) {
         this->vertex_shader_path = vertex_path;
         this->fragment_shader_path = fragment_path;
+        world.get_file_watcher().watch(vertex_path, get_rc());
+        world.get_file_watcher().watch(fragment_path, get_rc());
         reload_from_file();
         return *this;
     }
 
+    Program &Program::from_file_async(const std::string &vertex_path, const std::string &fragment_path) {
+        this->vertex_shader_path = vertex_path;
+        this->fragment_shader_path = fragment_path;
+        world.get_file_watcher().watch(vertex_path, get_rc());
+        world.get_file_watcher().watch(fragment_path, get_rc());
+        reload_async();
+        return *this;
+    }
+
     Program &Program::from_source(const std::string &combined_shader_src) {
+        vertex_shader_path.clear();
+        fragment_shader_path.clear();
         reload_from_source(combined_shader_src, combined_shader_src);
         return *this;
     }
 
     Program &Program::from_source(const std::string &vertex_source, const std::string &fragment_source) {
+        vertex_shader_path.clear();
+        fragment_shader_path.clear();
         reload_from_source(vertex_source, fragment_source);
         return *this;
     }
@@ -76,12 +91,23 @@ namespace wrld::rsc {
     // }
 
     Program::~Program() {
+        // Programs never compiled may be destroyed by any thread
+        if (gl_program == 0)
+            return;
+
         glDeleteShader(vertex_shader);
         glDeleteShader(fragment_shader);
         glDeleteProgram(gl_program);
     }
 
-    void Program::use() const { glUseProgram(gl_program); }
+    void Program::use() const {
+        if (gl_program == 0) {
+            // Not compiled yet: the default shaders are used until the program is loaded
+            reload_from_source(shader::DEFAULT_VERTEX, shader::DEFAULT_FRAGMENT);
+        }
+
+        glUseProgram(gl_program);
+    }
 
     void Program::set_uniform(const std::string &uniform, const float value) const {
         const GLint uniform_loc = glGetUniformLocation(gl_program, uniform.c_str());
@@ -174,15 +200,18 @@ namespace wrld::rsc {
         set_uniform(uniform + ".do_lighting", material.is_doing_lighting());
     }
 
-    void Program::reload() const {
-        wrldInfo("Reloading shaders...");
-        // Compile the shaders, check for error
-        compile_shader(vertex_shader, vertex_shader_path, VERTEX_SHADER);
-        compile_shader(fragment_shader, fragment_shader_path, FRAGMENT_SHADER);
+    void Program::reload_async() {
+        if (vertex_shader_path.empty())
+            return;
 
-        // glAttachShader(gl_program, vertex_shader);
-        // glAttachShader(gl_program, fragment_shader);
-        // glLinkProgram(gl_program);
+        wrldInfo(std::format("Reloading shaders {} and {} in background", vertex_shader_path, fragment_shader_path));
+        world.get_loader().load(get_rc(), [vertex_path = vertex_shader_path, fragment_path = fragment_shader_path] {
+            const std::string vertex_src = read_file(vertex_path);
+            const std::string fragment_src = read_file(fragment_path);
+            return ResourceUpload{[vertex_src, fragment_src](Resource &program) {
+                static_cast<Program &>(program).reload_from_source(vertex_src, fragment_src);
+            }};
+        });
     }
 
     void Program::set_uniform(const std::string &uniform, const glm::mat4x4 &value) const {
@@ -211,75 +240,56 @@ namespace wrld::rsc {
     }
 
     void Program::reload_from_file() {
-        if (vertex_shader == 0) {
-            vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-            if (vertex_shader == 0) {
-                throw std::runtime_error("Unable to create OpenGL vertex shader object");
-            }
-        }
-
-        if (fragment_shader == 0) {
-            fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-            if (fragment_shader == 0) {
-                throw std::runtime_error("Unable to create OpenGL fragment shader object");
-            }
-        }
-
-        // Compile the shaders, check for error
         wrldInfo(std::format("Loading shader {}", vertex_shader_path));
         const std::string vertex_src = read_file(vertex_shader_path);
         wrldInfo(std::format("Loading shader {}", fragment_shader_path));
         const std::string fragment_src = read_file(fragment_shader_path);
 
-        compile_shader(vertex_shader, vertex_src, VERTEX_SHADER);
-        compile_shader(fragment_shader, fragment_src, FRAGMENT_SHADER);
-
-        // Create the program
-        if (gl_program == 0) {
-            gl_program = glCreateProgram();
-            if (gl_program == 0) {
-                throw std::runtime_error("Unable to create OpenGL program object");
-            }
-
-            glAttachShader(gl_program, vertex_shader);
-            glAttachShader(gl_program, fragment_shader);
-        }
-
-        glLinkProgram(gl_program);
-
-        compiled_once = true;
+        reload_from_source(vertex_src, fragment_src);
     }
 
-    void Program::reload_from_source(const std::string &vertex_src, const std::string &fragment_src) {
-        if (vertex_shader == 0) {
-            vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-            if (vertex_shader == 0) {
-                throw std::runtime_error("Unable to create OpenGL vertex shader object");
-            }
-        }
+    void Program::reload_from_source(const std::string &vertex_src, const std::string &fragment_src) const {
+        // Build a whole new program: the current one stays valid if anything fails
+        const GLuint new_vertex_shader = glCreateShader(GL_VERTEX_SHADER);
+        const GLuint new_fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
+        const GLuint new_program = glCreateProgram();
 
-        if (fragment_shader == 0) {
-            fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-            if (fragment_shader == 0) {
-                throw std::runtime_error("Unable to create OpenGL fragment shader object");
+        try {
+            if (new_vertex_shader == 0 || new_fragment_shader == 0 || new_program == 0) {
+                throw std::runtime_error("Unable to create OpenGL program objects");
             }
-        }
 
-        compile_shader(vertex_shader, vertex_src, VERTEX_SHADER);
-        compile_shader(fragment_shader, fragment_src, FRAGMENT_SHADER);
+            // Compile the shaders, check for error
+            compile_shader(new_vertex_shader, vertex_src, VERTEX_SHADER);
+            compile_shader(new_fragment_shader, fragment_src, FRAGMENT_SHADER);
 
-        // Create the program
-        if (gl_program == 0) {
-            gl_program = glCreateProgram();
-            if (gl_program == 0) {
-                throw std::runtime_error("Unable to create OpenGL program object");
-            }
+            glAttachShader(new_program, new_vertex_shader);
+            glAttachShader(new_program, new_fragment_shader);
+            glLinkProgram(new_program);
+
+            int success;
+            glGetProgramiv(new_program, GL_LINK_STATUS, &success);
 
-            glAttachShader(gl_program, vertex_shader);
-            glAttachShader(gl_program, fragment_shader);
+            if (!success) {
+                char infoLog[512];
+                glGetProgramInfoLog(new_program, 512, nullptr, infoLog);
+                throw std::runtime_error(std::format("Failed to link program: {}", infoLog));
+            }
+        } catch (...) {
+            // Zero names are silently ignored
+            glDeleteShader(new_vertex_shader);
+            glDeleteShader(new_fragment_shader);
+            glDeleteProgram(new_program);
+            throw;
         }
 
-        glLinkProgram(gl_program);
+        // Swap the program. The old one is kept alive by OpenGL while in use
+        glDeleteShader(vertex_shader);
+        glDeleteShader(fragment_shader);
+        glDeleteProgram(gl_program);
+        vertex_shader = new_vertex_shader;
+        fragment_shader = new_fragment_shader;
+        gl_program = new_program;
 
         compiled_once = true;
     }
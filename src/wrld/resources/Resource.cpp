@@ -6,23 +6,39 @@
 #include <wrld/resources/Rc.hpp>
 #include <wrld/World.hpp>
 
+#include <ranges>
 #include <utility>
 
 namespace wrld {
     Resource::Resource(std::string name, World &world /*, Rc<Resource> *rc*/) :
-        name(std::move(name)), world(world) /*, rc(rc)*/ {}
+        name(std::move(name)), type_id(TypeConstructionScope<Resource>::get_current()), world(world) /*, rc(rc)*/ {}
 
     std::string Resource::get_name() const { return name; }
 
+    TypeId Resource::get_type_id() const { return type_id; }
+
+    Rc<Resource> Resource::get_rc() const { return Rc<Resource>(slot); }
+
+    bool Resource::is_default() const { return slot != nullptr && slot->name == NO_NAME; }
+
     bool Resource::has_resource(const std::string &unique_name) const {
         return attached_resources.contains(unique_name);
     }
 
+    Resource::~Resource() {
+        world.get_gpu_memory().untrack(*this);
+
+        for (const ResourceAttachment &attachment: attached_resources | std::views::values)
+            attachment.resource.detach_user(&attachment.user_position);
+    }
+
     void Resource::detach_resource(const std::string &unique_name) {
-        if (!attached_resources.contains(unique_name))
+        const auto it = attached_resources.find(unique_name);
+        if (it == attached_resources.end())
             return;
 
-        attached_resources[unique_name].detach_resource_user(std::type_index(typeid(*this)), get_name());
+        it->second.resource.detach_user(&it->second.user_position);
+        attached_resources.erase(it);
     }
 
     // void Resource::detach_resource(const std::string &unique_name) {
@@ -0,0 +1,115 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/resources/ResourceLoader.hpp>
+
+#include <wrld/World.hpp>
+#include <wrld/logs.hpp>
+
+#include <format>
+#include <thread>
+
+namespace wrld {
+    ResourceLoader::ResourceLoader(World &world) : world(world), decode_pool(DECODE_THREAD_COUNT) {}
+
+    void ResourceLoader::load(const Rc<Resource> &resource, std::function<ResourceUpload()> decode) {
+        auto load = std::make_unique<Load>();
+        load->resource = resource;
+
+        // The load is only destroyed once decoded (the thread pool runs every task before being destroyed)
+        decode_pool.submit([load = load.get(), decode = std::move(decode)] {
+            try {
+                load->result = decode();
+            } catch (...) {
+                load->error = std::current_exception();
+            }
+            load->decoded.store(true, std::memory_order_release);
+        });
+
+        // Older loads of the resource are cancelled by the main thread, which owns them
+        const std::lock_guard lock(incoming_mutex);
+        incoming.push_back(std::move(load));
+    }
+
+    size_t ResourceLoader::upload(const std::chrono::microseconds time_budget, const size_t byte_budget) {
+        const auto start = std::chrono::steady_clock::now();
+        drain_incoming();
+
+        size_t uploaded = 0;
+        size_t bytes = 0;
+        for (auto &load: loads) {
+            if (!load->decoded.load(std::memory_order_acquire))
+                continue;
+
+            if (!load->cancelled) {
+                // Over budget: the remaining loads wait for the next frame
+                if (uploaded > 0 && (bytes + load->result.bytes > byte_budget ||
+                                     std::chrono::steady_clock::now() - start >= time_budget))
+                    break;
+
+                bytes += load->result.bytes;
+                uploaded += 1;
+                complete(*load);
+            }
+            load.reset();
+        }
+
+        std::erase(loads, nullptr);
+        return uploaded;
+    }
+
+    void ResourceLoader::finish() {
+        // Uploads and the workers helped may start new loads
+        for (drain_incoming(); !loads.empty(); drain_incoming()) {
+            for (auto &load: loads) {
+                // Help the workers instead of blocking
+                while (!load->decoded.load(std::memory_order_acquire)) {
+                    if (!decode_pool.run_pending_task())
+                        std::this_thread::yield();
+                }
+
+                if (!load->cancelled)
+                    complete(*load);
+            }
+
+            loads.clear();
+        }
+    }
+
+    size_t ResourceLoader::get_pending_count() const {
+        const std::lock_guard lock(incoming_mutex);
+        return loads.size() + incoming.size();
+    }
+
+    bool ResourceLoader::uploaded_since(const Tick since) const { return last_upload > since; }
+
+    void ResourceLoader::drain_incoming() {
+        std::vector<std::unique_ptr<Load>> drained;
+        {
+            const std::lock_guard lock(incoming_mutex);
+            drained.swap(incoming);
+        }
+
+        for (auto &load: drained) {
+            for (const auto &previous: loads) {
+                if (previous->resource == load->resource)
+                    previous->cancelled = true;
+            }
+            loads.push_back(std::move(load));
+        }
+    }
+
+    void ResourceLoader::complete(Load &load) {
+        try {
+            if (load.error)
+                std::rethrow_exception(load.error);
+            load.result.upload(*load.resource.get_mut());
+        } catch (const std::exception &e) {
+            wrldError(std::format("Unable to load {}: {}", load.resource->get_name(), e.what()));
+            return;
+        }
+
+        last_upload = world.get_tick();
+    }
+} // namespace wrld
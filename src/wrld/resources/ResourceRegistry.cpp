@@ -0,0 +1,184 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/resources/ResourceRegistry.hpp>
+
+#include <wrld/resources/Resource.hpp>
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+namespace wrld {
+    ResourceRegistry::ResourceRegistry() {
+        for (TypeId type_id = 0; type_id < MAX_RESOURCE_TYPES; type_id++)
+            storages[type_id] = std::make_unique<ResourceStorage>(type_id);
+    }
+
+    // Defined here, where Resource is complete
+    ResourceRegistry::~ResourceRegistry() = default;
+
+    ResourceStorage &ResourceRegistry::get_storage(const TypeId type_id) {
+        get_shard(type_id);
+        return *storages[type_id];
+    }
+
+    NameID ResourceRegistry::reserve_name(const TypeId type_id, const std::string_view name) {
+        Shard &shard = get_shard(type_id);
+        const NameID name_id = intern(name);
+
+        const std::unique_lock lock(shard.mutex);
+        if (shard.names.try_emplace(name_id).second)
+            return name_id;
+
+        // Suffixes only increase: each one is tried at most once for a name
+        uint32_t &suffix = shard.name_suffixes[name_id];
+
+        NameID unique_id;
+        do {
+            suffix += 1;
+            unique_id = intern(std::format("{}:{}", name, suffix));
+        } while (!shard.names.try_emplace(unique_id).second);
+
+        return unique_id;
+    }
+
+    void ResourceRegistry::insert(const TypeId type_id, const NameID name, Rc<Resource> resource) {
+        Shard &shard = get_shard(type_id);
+        const std::unique_lock lock(shard.mutex);
+        shard.names.at(name) = std::move(resource);
+    }
+
+    void ResourceRegistry::release_name(const TypeId type_id, const NameID name) {
+        Shard &shard = get_shard(type_id);
+        const std::unique_lock lock(shard.mutex);
+        shard.names.erase(name);
+    }
+
+    Rc<Resource> ResourceRegistry::find(const TypeId type_id, const std::string_view name) const {
+        const Shard &shard = get_shard(type_id);
+
+        NameID name_id;
+        {
+            const std::shared_lock lock(name_strings_mutex);
+            name_id = name_strings.find(name);
+        }
+        if (name_id == NO_NAME)
+            return {};
+
+        const std::shared_lock lock(shard.mutex);
+        const auto it = shard.names.find(name_id);
+        // Reserved names have an empty Rc
+        return it == shard.names.end() ? Rc<Resource>() : it->second;
+    }
+
+    void ResourceRegistry::remove(const TypeId type_id, const ResourceHandle handle) {
+        if (handle.index == ResourceHandle::NO_INDEX)
+            return;
+
+        Shard &shard = get_shard(type_id);
+        const NameID name = storages[type_id]->get_slot(handle.index).name;
+
+        // Released after unlocking: destroying the resource may remove others
+        Rc<Resource> removed;
+        {
+            const std::unique_lock lock(shard.mutex);
+            const auto it = shard.names.find(name);
+            // The name may have been given to another resource since this one was removed
+            if (it != shard.names.end() && it->second.get() != nullptr && it->second.get_handle() == handle) {
+                removed = std::move(it->second);
+                shard.names.erase(it);
+            }
+        }
+    }
+
+    bool ResourceRegistry::remove_if_unused(ResourceSlot &slot) {
+        if (slot.name == NO_NAME)
+            return false;
+
+        Shard &shard = get_shard(slot.type_id);
+
+        Rc<Resource> removed;
+        {
+            // Other threads only get an Rc to a named resource from its name, so the reference count can not
+            // grow while the lock is held. Resources acquired from their handle in the meantime lose their name.
+            const std::unique_lock lock(shard.mutex);
+            if (!slot.users.empty() || slot.references.load(std::memory_order_acquire) != 2)
+                return false;
+
+            const auto it = shard.names.find(slot.name);
+            if (it == shard.names.end() || it->second.get() == nullptr || it->second.get_handle() != slot.handle)
+                return false;
+
+            removed = std::move(it->second);
+            shard.names.erase(it);
+        }
+        return true;
+    }
+
+    std::string_view ResourceRegistry::get_name(const NameID name) const {
+        // Interned strings never move: the view stays valid after unlocking
+        const std::shared_lock lock(name_strings_mutex);
+        return name_strings.get(name);
+    }
+
+    Rc<Resource> ResourceRegistry::get_default(const TypeId type_id) const {
+        const Shard &shard = get_shard(type_id);
+        if (!shard.has_default.load(std::memory_order_acquire))
+            return {};
+        return shard.default_resource;
+    }
+
+    Rc<Resource> ResourceRegistry::get_or_create_default(const TypeId type_id,
+                                                         const std::function<Rc<Resource>()> &create) {
+        Shard &shard = get_shard(type_id);
+        if (shard.has_default.load(std::memory_order_acquire))
+            return shard.default_resource;
+
+        const std::lock_guard lock(shard.default_mutex);
+        // Another thread may have created it while this one was waiting
+        if (!shard.has_default.load(std::memory_order_relaxed)) {
+            shard.default_resource = create();
+            shard.has_default.store(true, std::memory_order_release);
+        }
+        return shard.default_resource;
+    }
+
+    ResourcePool ResourceRegistry::get_resources() const {
+        ResourcePool pool;
+
+        for (TypeId type_id = 0; type_id < MAX_RESOURCE_TYPES; type_id++) {
+            const Shard &shard = shards[type_id];
+            const std::shared_lock lock(shard.mutex);
+            if (shard.names.empty())
+                continue;
+
+            pool.resize(type_id + 1);
+            for (const auto &[name, resource]: shard.names) {
+                if (resource.get() != nullptr)
+                    pool[type_id].emplace(name, resource);
+            }
+        }
+
+        return pool;
+    }
+
+    ResourceRegistry::Shard &ResourceRegistry::get_shard(const TypeId type_id) const {
+        if (type_id >= MAX_RESOURCE_TYPES)
+            throw std::runtime_error(std::format("Too many resource types (maximum is {})", MAX_RESOURCE_TYPES));
+        // The shards are only changed under their locks
+        return const_cast<Shard &>(shards[type_id]);
+    }
+
+    NameID ResourceRegistry::intern(const std::string_view name) {
+        {
+            const std::shared_lock lock(name_strings_mutex);
+            if (const NameID name_id = name_strings.find(name); name_id != NO_NAME)
+                return name_id;
+        }
+
+        const std::unique_lock lock(name_strings_mutex);
+        return name_strings.intern(name);
+    }
+} // namespace wrld
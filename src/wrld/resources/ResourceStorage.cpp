@@ -0,0 +1,148 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/resources/Resource.hpp>
+#include <wrld/resources/ResourceStorage.hpp>
+
+namespace wrld {
+    void ResourceUsers::add_component_user(const TypeId type_id, const EntityID entity, uint32_t *position) {
+        const std::lock_guard lock(mutex);
+        *position = static_cast<uint32_t>(users.size());
+        users.push_back({type_id, nullptr, entity, position});
+        component_user_count += 1;
+    }
+
+    void ResourceUsers::add_resource_user(const TypeId type_id, const Resource *resource, uint32_t *position) {
+        const std::lock_guard lock(mutex);
+        *position = static_cast<uint32_t>(users.size());
+        users.push_back({type_id, resource, NULL_ENTITY, position});
+    }
+
+    void ResourceUsers::remove(const uint32_t *position) {
+        const std::lock_guard lock(mutex);
+        const uint32_t index = *position;
+        if (users[index].resource == nullptr)
+            component_user_count -= 1;
+
+        users[index] = users.back();
+        *users[index].position = index;
+        users.pop_back();
+    }
+
+    size_t ResourceUsers::get_component_user_count() const {
+        const std::lock_guard lock(mutex);
+        return component_user_count;
+    }
+
+    size_t ResourceUsers::get_resource_user_count() const {
+        const std::lock_guard lock(mutex);
+        return users.size() - component_user_count;
+    }
+
+    std::vector<ResourceUser> ResourceUsers::get_users() const {
+        const std::lock_guard lock(mutex);
+        return users;
+    }
+
+    bool ResourceUsers::empty() const {
+        const std::lock_guard lock(mutex);
+        return users.empty();
+    }
+
+    ResourceStorage::ResourceStorage(const TypeId type_id) : type_id(type_id) {}
+
+    // Defined here, where Resource is complete
+    ResourceStorage::~ResourceStorage() = default;
+
+    ResourceSlot &ResourceStorage::insert(std::unique_ptr<Resource> resource, const NameID name) {
+        const std::lock_guard lock(mutex);
+
+        ResourceSlot *slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            if (last_chunk_used == CHUNK_SIZE) {
+                chunks.push_back(std::make_unique<ResourceSlot[]>(CHUNK_SIZE));
+                last_chunk_used = 0;
+            }
+            slot = &chunks.back()[last_chunk_used];
+            slot->handle.index = static_cast<uint32_t>((chunks.size() - 1) * CHUNK_SIZE + last_chunk_used);
+            slot->storage = this;
+            last_chunk_used += 1;
+        }
+
+        slot->resource = std::move(resource);
+        slot->type_id = type_id;
+        slot->name = name;
+        slot->references.store(1, std::memory_order_relaxed);
+        used += 1;
+        return *slot;
+    }
+
+    ResourceSlot *ResourceStorage::acquire(const ResourceHandle handle) {
+        const std::lock_guard lock(mutex);
+
+        if (handle.index == ResourceHandle::NO_INDEX || handle.index / CHUNK_SIZE >= chunks.size())
+            return nullptr;
+
+        ResourceSlot &slot = chunks[handle.index / CHUNK_SIZE][handle.index % CHUNK_SIZE];
+        if (slot.handle.generation != handle.generation || slot.resource == nullptr)
+            return nullptr;
+
+        // Under the lock: a concurrent release sees the reference and keeps the resource
+        slot.references.fetch_add(1, std::memory_order_relaxed);
+        return &slot;
+    }
+
+    ResourceSlot *ResourceStorage::acquire_at(const size_t index) {
+        const std::lock_guard lock(mutex);
+
+        if (index / CHUNK_SIZE >= chunks.size())
+            return nullptr;
+
+        ResourceSlot &slot = chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+        if (slot.resource == nullptr)
+            return nullptr;
+
+        slot.references.fetch_add(1, std::memory_order_relaxed);
+        return &slot;
+    }
+
+    void ResourceStorage::release(ResourceSlot &slot) {
+        std::unique_ptr<Resource> resource;
+        {
+            const std::lock_guard lock(mutex);
+
+            // An Rc may have been created from a handle after the count dropped to 0
+            if (slot.references.load(std::memory_order_acquire) != 0 || slot.resource == nullptr)
+                return;
+
+            resource = std::move(slot.resource);
+            slot.handle.generation += 1;
+            free_slots.push_back(&slot);
+            used -= 1;
+        }
+
+        // Destroyed out of the lock: the resource may release other resources of the same type
+        resource.reset();
+    }
+
+    size_t ResourceStorage::size() const {
+        const std::lock_guard lock(mutex);
+        return used;
+    }
+
+    TypeId ResourceStorage::get_type_id() const { return type_id; }
+
+    size_t ResourceStorage::get_slot_count() const {
+        const std::lock_guard lock(mutex);
+        return chunks.empty() ? 0 : (chunks.size() - 1) * CHUNK_SIZE + last_chunk_used;
+    }
+
+    ResourceSlot &ResourceStorage::get_slot(const size_t index) {
+        const std::lock_guard lock(mutex);
+        return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    }
+} // namespace wrld
@@ -3,6 +3,7 @@
 //
 
 #include <wrld/resources/Texture.hpp>
+#include <wrld/World.hpp>
 #include <wrld/logs.hpp>
 
 #include <format>
@@ -11,18 +12,49 @@
 #include <stdexcept>
 
 namespace wrld::rsc {
-    Texture::Texture(const std::string &name, World &world /*, Rc<Resource> *rc*/) : Resource(name, world /*, rc*/) {
-        reload();
-    }
+    size_t TextureImage::size() const { return static_cast<size_t>(width) * height * channels; }
+
+    Texture::Texture(const std::string &name, World &world /*, Rc<Resource> *rc*/) : Resource(name, world /*, rc*/) {}
 
     Texture &Texture::set_texture(const std::string &texture_path, const aiTextureType type, const bool flip_textures) {
         this->path = texture_path;
         this->type = type;
         this->flip_textures = flip_textures;
+        world.get_file_watcher().watch(texture_path, get_rc());
         reload();
         return *this;
     }
 
+    Texture &Texture::set_texture_async(const std::string &texture_path, const aiTextureType type,
+                                        const bool flip_textures) {
+        this->path = texture_path;
+        this->type = type;
+        this->flip_textures = flip_textures;
+        world.get_file_watcher().watch(texture_path, get_rc());
+
+        wrldInfo(std::format("Loading {} texture in background : {}", aiTextureTypeToString(type), path));
+        world.get_loader().load(get_rc(), [texture_path, flip_textures] {
+            const TextureImage image = decode(texture_path, flip_textures);
+            return ResourceUpload{[image](Resource &texture) { static_cast<Texture &>(texture).upload(image); },
+                                  image.size()};
+        });
+        return *this;
+    }
+
+    TextureImage Texture::decode(const std::string &path, const bool flip) {
+        // Thread-local setting, as workers may decode other images at the same time
+        stbi_set_flip_vertically_on_load_thread(flip);
+
+        TextureImage image;
+        unsigned char *data = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0);
+        if (data == nullptr) {
+            throw std::runtime_error(std::format("Error while loading texture {}", path));
+        }
+
+        image.pixels = std::shared_ptr<unsigned char>(data, stbi_image_free);
+        return image;
+    }
+
     // Texture::Texture(Texture &&other) noexcept :
     //     gl_texture(other.gl_texture), path(std::move(other.path)), type(other.type),
     //     flip_textures(other.flip_textures) {
@@ -43,34 +75,50 @@ namespace wrld::rsc {
     //     return *this;
     // }
 
+    void Texture::reload_async() {
+        // Copies, as set_texture_async overwrites them
+        const std::string texture_path = path;
+        set_texture_async(texture_path, type, flip_textures);
+    }
+
     void Texture::use(const unsigned unit) const {
+        world.get_gpu_memory().touch(*this);
+
+        if (gl_texture == 0) {
+            // Not loaded yet, or evicted: the default texture is used instead, and loaded on its first use
+            const Rc<Texture> default_texture = world.get_default<Texture>();
+            if (default_texture.get() != this) {
+                default_texture->use(unit);
+                return;
+            }
+
+            default_texture.get_mut()->reload();
+        }
+
         glActiveTexture(GL_TEXTURE0 + unit);
         glBindTexture(GL_TEXTURE_2D, gl_texture);
     }
 
-    Texture::~Texture() { glDeleteTextures(1, &gl_texture); }
+    const std::string &Texture::get_path() const { return path; }
 
-    void Texture::reload() {
-        stbi_set_flip_vertically_on_load(flip_textures);
+    aiTextureType Texture::get_texture_type() const { return type; }
 
-        wrldInfo(std::format("Loading {} texture : {}", aiTextureTypeToString(type), path));
-
-        // Filtering for regular textures
-        // todo: move to material
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    bool Texture::is_flipped() const { return flip_textures; }
 
-        // Load texture file
-        int width, height, nb_channels;
-        unsigned char *data = stbi_load(path.c_str(), &width, &height, &nb_channels, 0);
+    Texture::~Texture() {
+        // Textures never uploaded may be destroyed by any thread
+        if (gl_texture != 0)
+            glDeleteTextures(1, &gl_texture);
+    }
 
-        if (data == nullptr) {
-            stbi_image_free(data);
-            throw std::runtime_error(std::format("Error while loading texture {}", path));
-        }
+    void Texture::reload() {
+        wrldInfo(std::format("Loading {} texture : {}", aiTextureTypeToString(type), path));
+        upload(decode(path, flip_textures));
+    }
 
+    void Texture::upload(const TextureImage &image) {
         GLenum format;
-        switch (nb_channels) {
+        switch (image.channels) {
             case 3: {
                 format = GL_RGB;
             } break;
@@ -78,9 +126,8 @@ namespace wrld::rsc {
                 format = GL_RGBA;
             } break;
             default: {
-                stbi_image_free(data);
                 throw std::runtime_error(
-                        std::format("Only RGB and RGBA images are supported for now. Nbchannels: {}", nb_channels));
+                        std::format("Only RGB and RGBA images are supported for now. Nbchannels: {}", image.channels));
             }
         }
 
@@ -89,9 +136,33 @@ namespace wrld::rsc {
         }
 
         glBindTexture(GL_TEXTURE_2D, gl_texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+
+        // Filtering for regular textures
+        // todo: move to material
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE,
+                     image.pixels.get());
         glGenerateMipmap(GL_TEXTURE_2D);
 
-        stbi_image_free(data);
+        // The mipmaps add a third of the image
+        world.get_gpu_memory().track(*this, image.size() * 4 / 3);
+    }
+
+    bool Texture::evict_gpu_memory() {
+        // The default texture replaces the evicted ones
+        if (is_default())
+            return false;
+
+        glDeleteTextures(1, &gl_texture);
+        gl_texture = 0;
+        return true;
+    }
+
+    void Texture::restore_gpu_memory() {
+        // Copy, as set_texture_async overwrites it
+        const std::string texture_path = path;
+        set_texture_async(texture_path, type, flip_textures);
     }
 } // namespace wrld::rsc
@@ -16,6 +16,7 @@
 #include <wrld/systems/RendererSystem.hpp>
 #include <wrld/components/Camera3D.hpp>
 #include <wrld/components/StaticModel.hpp>
+#include <wrld/components/Transform.hpp>
 
 #include <GLFW/glfw3.h>
 #include <wrld/tools/Geometry.hpp>
@@ -60,24 +61,10 @@ namespace wrld {
         pass1_program.get_mut()->set_uniform("view", view_matrix);
         pass1_program.get_mut()->set_uniform("projection", projection_matrix);
 
-        // Find each entity with a model, get its transform, and render it.
-        visible_models = 0;
-        const bool do_culling = camera.is_culling();
-        for (const std::vector model_entities = world.get_entities_with_component<cpt::StaticModel>();
-             const auto entity: model_entities) {
-            // Skip unseen models if culling
-            if (!tools::Geometry::is_visible(world, entity, camera.get_entity()) && do_culling)
-                continue;
-
-            visible_models += 1;
-            const auto model_cmpnt = world.get_component_opt<cpt::StaticModel>(entity).value();
-            const auto &model = model_cmpnt->get_model();
-
-            glm::mat4x4 model_matrix = get_entity_transform(entity);
-
-            // Actual draw call
-            draw_model(model.get_ref(), model_matrix, pass1_program.get_ref());
-        }
+        // Render each visible model
+        update_draw_list(camera, projection_matrix * view_matrix);
+        for (const auto &item: draw_list)
+            draw_model(*item.model, item.model_matrix, item.normal_matrix, pass1_program.get_ref());
 
         // SECOND PASS
         const auto &window_fb = Main::get_window_viewport();
@@ -107,8 +94,8 @@ namespace wrld {
         pass2_program.get_mut()->set_uniform("view_pos", camera.get_position());
 
         // Light information
-        const std::vector<PointLightData> point_lights = get_point_lights();
-        const std::vector<DirectionalLightData> directional_lights = get_directional_lights();
+        const auto point_light_data = get_point_lights();
+        const auto directional_light_data = get_directional_lights();
 
         const EnvironmentData environment_data = get_environment(camera);
 
@@ -117,16 +104,16 @@ namespace wrld {
         pass2_program.get_mut()->set_uniform("ambiant_light.intensity", environment_data.ambiant_light.intensity);
 
         // Point light dependent uniforms
-        pass2_program.get_mut()->set_uniform("point_light_nb", static_cast<unsigned>(point_lights.size()));
-        for (const auto &[i, pl]: std::views::enumerate(point_lights)) {
+        pass2_program.get_mut()->set_uniform("point_light_nb", static_cast<unsigned>(point_light_data.size()));
+        for (const auto &[i, pl]: std::views::enumerate(point_light_data)) {
             pass2_program.get_mut()->set_uniform(std::format("point_lights[{}].position", i), pl.position);
             pass2_program.get_mut()->set_uniform(std::format("point_lights[{}].color", i), pl.color);
             pass2_program.get_mut()->set_uniform(std::format("point_lights[{}].intensity", i), pl.intensity);
         }
 
         // Directional light dependent uniforms
-        pass2_program.get_mut()->set_uniform("directional_lights_nb", static_cast<unsigned>(directional_lights.size()));
-        for (const auto &[i, dl]: std::views::enumerate(directional_lights)) {
+        pass2_program.get_mut()->set_uniform("directional_lights_nb", static_cast<unsigned>(directional_light_data.size()));
+        for (const auto &[i, dl]: std::views::enumerate(directional_light_data)) {
             pass2_program.get_mut()->set_uniform(std::format("directional_lights[{}].direction", i), dl.direction);
             pass2_program.get_mut()->set_uniform(std::format("directional_lights[{}].color", i), dl.color);
             pass2_program.get_mut()->set_uniform(std::format("directional_lights[{}].intensity", i), dl.intensity);
@@ -0,0 +1,125 @@
+//
+// Created by leo on 10/18/25.
+//
+
+#include <wrld/systems/HierarchySystem.hpp>
+
+#include <wrld/components/Parent.hpp>
+#include <wrld/components/Transform.hpp>
+#include <wrld/logs.hpp>
+
+#include <algorithm>
+#include <format>
+#include <ranges>
+#include <unordered_map>
+
+namespace wrld {
+    HierarchySystem::HierarchySystem(World &world) : System(world) {
+        reads<cpt::Parent>();
+        writes<cpt::Transform>();
+    }
+
+    void HierarchySystem::exec() {
+        if (world.component_changed_since<cpt::Parent>(last_run_tick) || transform_added()) {
+            rebuild();
+        } else {
+            // Nothing moved (removing a Transform, or deleting an entity, also changes the storage)
+            if (!world.component_changed_since<cpt::Transform>(last_run_tick))
+                return;
+
+            // Only the subtrees whose root moved
+            for (size_t i = 0; i < nodes.size(); i++)
+                dirty[i] = world.component_changed_since<cpt::Transform>(nodes[i].entity, last_run_tick);
+        }
+
+        if (!propagate()) {
+            rebuild();
+            propagate();
+        }
+    }
+
+    void HierarchySystem::rebuild() {
+        // Entities leaving the hierarchy are placed back in world space
+        for (const Node &node: nodes) {
+            if (node.parent == NO_PARENT || world.has_components<cpt::Parent>(node.entity))
+                continue;
+            if (const auto transform = world.get_component_opt<cpt::Transform>(node.entity))
+                transform.value()->set_parent_matrix(glm::mat4x4(1.0f));
+        }
+
+        nodes.clear();
+        missing_transforms.clear();
+
+        // Children of each parent having a Transform
+        std::unordered_map<EntityID, std::vector<EntityID>> children;
+        size_t child_count = 0;
+        for (const auto &[entity, parent]: world.view<cpt::Parent>()) {
+            const auto transform = world.get_component_opt<cpt::Transform>(entity);
+            if (!transform.has_value()) {
+                missing_transforms.push_back(entity);
+                continue;
+            }
+
+            const EntityID parent_id = parent.get_parent();
+            if (world.has_components<cpt::Transform>(parent_id)) {
+                children[parent_id].push_back(entity);
+                child_count += 1;
+            } else {
+                // Orphans are roots: their model matrix is their local matrix
+                transform.value()->set_parent_matrix(glm::mat4x4(1.0f));
+                missing_transforms.push_back(parent_id);
+            }
+        }
+
+        // Roots are the parents that are not children themselves
+        for (const EntityID parent_id: children | std::views::keys) {
+            const auto parent = world.get_component_opt<cpt::Parent>(parent_id);
+            if (!parent.has_value() || !children.contains(parent.value()->get_parent()))
+                nodes.push_back({parent_id, NO_PARENT});
+        }
+
+        // Breadth-first traversal: nodes is its own queue
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const auto it = children.find(nodes[i].entity);
+            if (it == children.end())
+                continue;
+            for (const EntityID child: it->second)
+                nodes.push_back({child, static_cast<uint32_t>(i)});
+        }
+
+        // Entities in a cycle are never reached from a root
+        const size_t reached = nodes.size() - std::ranges::count(nodes, NO_PARENT, &Node::parent);
+        if (reached != child_count)
+            wrldError(std::format("{} entities are their own ancestor, their Parent is ignored", child_count - reached));
+
+        model_matrices.assign(nodes.size(), glm::mat4x4(1.0f));
+        dirty.assign(nodes.size(), true);
+    }
+
+    bool HierarchySystem::transform_added() const {
+        return std::ranges::any_of(missing_transforms,
+                                   [&](const EntityID id) { return world.has_components<cpt::Transform>(id); });
+    }
+
+    bool HierarchySystem::propagate() {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const Node &node = nodes[i];
+            if (node.parent != NO_PARENT && dirty[node.parent])
+                dirty[i] = true;
+
+            if (!world.entity_exists(node.entity))
+                return false;
+            if (!dirty[i])
+                continue;
+
+            const auto transform = world.get_component_opt<cpt::Transform>(node.entity);
+            if (!transform.has_value())
+                return false;
+
+            if (node.parent != NO_PARENT)
+                transform.value()->set_parent_matrix(model_matrices[node.parent]);
+            model_matrices[i] = transform.value()->model_matrix();
+        }
+        return true;
+    }
+} // namespace wrld
@@ -13,7 +13,9 @@
 #include <wrld/components/Environment.hpp>
 #include <wrld/components/PointLight.hpp>
 #include <wrld/shaders/skybox_shader.hpp>
+#include <wrld/tags.hpp>
 
+#include <algorithm>
 #include <format>
 #include <iostream>
 #include <wrld/logs.hpp>
@@ -31,13 +33,24 @@ namespace wrld {
                                      const std::optional<Rc<rsc::CubemapTexture>> &skybox, const GLuint vao) :
         vao(vao), ambiant_light(ambiant_light), skybox(skybox) {}
 
-    RendererSystem::RendererSystem(World &world, GLFWwindow *window) : System(world), window(window) {
+    RendererSystem::RendererSystem(World &world, GLFWwindow *window) :
+        System(world), window(window), cameras(world.query<cpt::Camera3D>()) {
+        // Uses the OpenGL context
+        pin_to_main_thread();
+        reads<cpt::Camera3D, cpt::Environment, cpt::StaticModel, cpt::Transform, cpt::PointLight,
+              cpt::DirectionalLight>();
+
         const auto program = world.create_resource<rsc::Program>("skybox_program");
         program.get_mut()->from_source(shader::SKYBOX);
         skybox_program = program;
+
+        observe_world();
     }
 
-    RendererSystem::~RendererSystem() = default;
+    RendererSystem::~RendererSystem() {
+        for (const ObserverID id: observers)
+            world.remove_observer(id);
+    }
 
     void RendererSystem::exec() {
         // Find the first camera in the world. It will be the render
@@ -45,9 +58,11 @@ namespace wrld {
         // todo: in the future, each camera will be attached to a Viewport.
         // We'll have to render each camera to its attached viewport.
 
-        if (const auto cameras = world.get_entities_with_component<cpt::Camera3D>(); !cameras.empty()) {
-            const auto camera = world.get_component<cpt::Camera3D>(cameras[0]);
-            render_camera(*camera);
+        refresh_transforms();
+
+        if (!cameras.empty()) {
+            const auto &[entity, camera] = *cameras.begin();
+            render_camera(camera);
         }
     }
 
@@ -61,10 +76,9 @@ namespace wrld {
         return glm::mat4x4(1.0);
     }
 
-    std::optional<std::shared_ptr<const cpt::Camera3D>> RendererSystem::get_camera() const {
-        if (const std::vector camera_entities = world.get_entities_with_component<cpt::Camera3D>();
-            !camera_entities.empty())
-            return world.get_component_opt<cpt::Camera3D>(camera_entities[0]);
+    std::optional<ComponentRef<const cpt::Camera3D>> RendererSystem::get_camera() const {
+        if (!cameras.empty())
+            return world.get_component_opt<cpt::Camera3D>(cameras.get_entities().front());
         return std::nullopt;
     }
 
@@ -93,8 +107,8 @@ namespace wrld {
 
         // Todo: When we will have multiple cameras, we should do that beforehand.
         // We don't need to call this each time we render a camera but once per exec().
-        const std::vector<PointLightData> point_lights = get_point_lights();
-        const std::vector<DirectionalLightData> directional_lights = get_directional_lights();
+        const auto point_light_data = get_point_lights();
+        const auto directional_light_data = get_directional_lights();
 
         if (environment_data.skybox.has_value()) {
             draw_skybox(environment_data.skybox.value().get_ref(), camera, environment_data.vao);
@@ -113,38 +127,171 @@ namespace wrld {
         program.set_uniform("ambiant_light.intensity", environment_data.ambiant_light.intensity);
 
         // Point light dependent uniforms
-        program.set_uniform("point_light_nb", static_cast<unsigned>(point_lights.size()));
-        for (const auto &[i, pl]: std::views::enumerate(point_lights)) {
+        program.set_uniform("point_light_nb", static_cast<unsigned>(point_light_data.size()));
+        for (const auto &[i, pl]: std::views::enumerate(point_light_data)) {
             program.set_uniform(std::format("point_lights[{}].position", i), pl.position);
             program.set_uniform(std::format("point_lights[{}].color", i), pl.color);
             program.set_uniform(std::format("point_lights[{}].intensity", i), pl.intensity);
         }
 
         // Directional light dependent uniforms
-        program.set_uniform("directional_lights_nb", static_cast<unsigned>(directional_lights.size()));
-        for (const auto &[i, dl]: std::views::enumerate(directional_lights)) {
+        program.set_uniform("directional_lights_nb", static_cast<unsigned>(directional_light_data.size()));
+        for (const auto &[i, dl]: std::views::enumerate(directional_light_data)) {
             program.set_uniform(std::format("directional_lights[{}].direction", i), dl.direction);
             program.set_uniform(std::format("directional_lights[{}].color", i), dl.color);
             program.set_uniform(std::format("directional_lights[{}].intensity", i), dl.intensity);
         }
 
-        // Find each entity with a model, get its transform, and render it.
-        visible_models = 0;
+        // Render each visible model
+        update_draw_list(camera, projection_matrix * view_matrix);
+        for (const auto &item: draw_list)
+            draw_model(*item.model, item.model_matrix, item.normal_matrix, program);
+    }
+
+    void RendererSystem::update_draw_list(const cpt::Camera3D &camera, const glm::mat4x4 &view_projection) {
         const bool do_culling = camera.is_culling();
-        for (const std::vector model_entities = world.get_entities_with_component<cpt::StaticModel>();
-             const auto entity: model_entities) {
-            // Skip unseen models if culling
-            if (!tools::Geometry::is_visible(world, entity, camera.get_entity()) && do_culling)
+
+        // In a static scene, the previous list is still valid.
+        // Models loaded in the background change without notifying the renderer: their bounds are new.
+        const bool outdated = last_run_tick == 0 || view_projection != draw_list_view_projection ||
+                              do_culling != draw_list_culling || renderables_changed ||
+                              world.tag_changed_since<tag::Hidden>(last_run_tick) ||
+                              world.get_loader().uploaded_since(last_run_tick);
+
+        if (outdated) {
+            draw_list.clear();
+            draw_list_view_projection = view_projection;
+            draw_list_culling = do_culling;
+            renderables_changed = false;
+
+            // Keep the visible renderables
+            const std::vector<DrawItem> &items = renderables.get_items();
+            const std::vector<EntityID> &entities = renderables.get_entities();
+            for (size_t i = 0; i < items.size(); i++) {
+                const DrawItem &item = items[i];
+                if (world.has_tag<tag::Hidden>(entities[i]))
+                    continue;
+
+                // Skip unseen models if culling
+                if (do_culling && !tools::Geometry::is_visible(*item.model, item.model_matrix, view_projection))
+                    continue;
+
+                draw_list.push_back(item);
+            }
+        }
+
+        visible_models = static_cast<unsigned>(draw_list.size());
+    }
+
+    void RendererSystem::observe_world() {
+        const auto make_draw_item = [this](const EntityID entity, const cpt::StaticModel &model_cmpnt) {
+            const auto transform = world.get_component_opt<cpt::Transform>(entity);
+            return DrawItem{model_cmpnt.get_model().get(),
+                            transform.has_value() ? transform.value()->model_matrix() : glm::mat4x4(1.0),
+                            transform.has_value() ? transform.value()->normal_matrix() : glm::mat4x4(1.0)};
+        };
+
+        const auto make_point_light = [this](const EntityID entity, const cpt::PointLight &light) {
+            // We need the light's position. If not found, we use {0, 0, 0}.
+            const auto transform = world.get_component_opt<cpt::Transform>(entity);
+            return PointLightData{transform.has_value() ? transform.value()->get_world_position() : glm::vec3{0.0},
+                                  light.get_color(), light.get_intensity()};
+        };
+
+        const auto make_directional_light = [this](const EntityID entity, const cpt::DirectionalLight &light) {
+            // We need the light's direction. If not found, we use {0, 0, 0}.
+            const auto transform = world.get_component_opt<cpt::Transform>(entity);
+            return DirectionalLightData{transform.has_value() ? transform.value()->get_direction() : glm::vec3{0.0},
+                                        light.get_color(), light.get_intensity()};
+        };
+
+        // Models
+        const auto update_renderable = [this, make_draw_item](const EntityID entity, const cpt::StaticModel &model) {
+            renderables.insert(entity, make_draw_item(entity, model));
+            renderables_changed = true;
+        };
+        observers.push_back(world.on_add<cpt::StaticModel>(update_renderable));
+        observers.push_back(world.on_change<cpt::StaticModel>(update_renderable));
+        observers.push_back(world.on_remove<cpt::StaticModel>([this](const EntityID entity, cpt::StaticModel &) {
+            renderables.erase(entity);
+            renderables_changed = true;
+        }));
+
+        // Lights
+        observers.push_back(world.on_add<cpt::PointLight>([this, make_point_light](const EntityID entity,
+                                                                                 const cpt::PointLight &light) {
+            point_lights.insert(entity, make_point_light(entity, light));
+        }));
+        observers.push_back(world.on_change<cpt::PointLight>([this, make_point_light](const EntityID entity,
+                                                                                    const cpt::PointLight &light) {
+            point_lights.insert(entity, make_point_light(entity, light));
+        }));
+        observers.push_back(world.on_remove<cpt::PointLight>(
+                [this](const EntityID entity, cpt::PointLight &) { point_lights.erase(entity); }));
+
+        observers.push_back(world.on_add<cpt::DirectionalLight>(
+                [this, make_directional_light](const EntityID entity, const cpt::DirectionalLight &light) {
+                    directional_lights.insert(entity, make_directional_light(entity, light));
+                }));
+        observers.push_back(world.on_change<cpt::DirectionalLight>(
+                [this, make_directional_light](const EntityID entity, const cpt::DirectionalLight &light) {
+                    directional_lights.insert(entity, make_directional_light(entity, light));
+                }));
+        observers.push_back(world.on_remove<cpt::DirectionalLight>(
+                [this](const EntityID entity, cpt::DirectionalLight &) { directional_lights.erase(entity); }));
+
+        // Added and changed transforms are refreshed in exec (see refresh_transforms)
+        observers.push_back(world.on_remove<cpt::Transform>([this](const EntityID entity, cpt::Transform &) {
+            if (DrawItem *item = renderables.find(entity)) {
+                item->model_matrix = glm::mat4x4(1.0);
+                item->normal_matrix = glm::mat4x4(1.0);
+                renderables_changed = true;
+            }
+            if (PointLightData *light = point_lights.find(entity))
+                light->position = glm::vec3{0.0};
+            if (DirectionalLightData *light = directional_lights.find(entity))
+                light->direction = glm::vec3{0.0};
+        }));
+
+        // Entities created before the renderer
+        for (const auto &[entity, model]: world.view<cpt::StaticModel>())
+            renderables.insert(entity, make_draw_item(entity, model));
+        for (const auto &[entity, light]: world.view<cpt::PointLight>())
+            point_lights.insert(entity, make_point_light(entity, light));
+        for (const auto &[entity, light]: world.view<cpt::DirectionalLight>())
+            directional_lights.insert(entity, make_directional_light(entity, light));
+    }
+
+    void RendererSystem::refresh_transforms() {
+        // Nothing to look at in a static scene
+        if (last_run_tick != 0 && !world.component_changed_since<cpt::Transform>(last_run_tick))
+            return;
+
+        const std::span<DrawItem> items = renderables.get_items_mut();
+        const std::vector<EntityID> &item_entities = renderables.get_entities();
+        for (size_t i = 0; i < items.size(); i++) {
+            if (!world.component_changed_since<cpt::Transform>(item_entities[i], last_run_tick))
                 continue;
 
-            visible_models += 1;
+            const auto transform = world.get_component<cpt::Transform>(item_entities[i]);
+            items[i].model_matrix = transform->model_matrix();
+            items[i].normal_matrix = transform->normal_matrix();
+            renderables_changed = true;
+        }
 
-            const auto model_cmpnt = world.get_component<cpt::StaticModel>(entity);
-            const auto &model = model_cmpnt->get_model();
-            glm::mat4x4 model_matrix = get_entity_transform(entity);
+        const std::span<PointLightData> points = point_lights.get_items_mut();
+        const std::vector<EntityID> &point_entities = point_lights.get_entities();
+        for (size_t i = 0; i < points.size(); i++) {
+            if (world.component_changed_since<cpt::Transform>(point_entities[i], last_run_tick))
+                points[i].position = world.get_component<cpt::Transform>(point_entities[i])->get_world_position();
+        }
 
-            // Actual draw call
-            draw_model(model.get_ref(), model_matrix, program);
+        const std::span<DirectionalLightData> directionals = directional_lights.get_items_mut();
+        const std::vector<EntityID> &directional_entities = directional_lights.get_entities();
+        for (size_t i = 0; i < directionals.size(); i++) {
+            if (world.component_changed_since<cpt::Transform>(directional_entities[i], last_run_tick))
+                directionals[i].direction =
+                        world.get_component<cpt::Transform>(directional_entities[i])->get_direction();
         }
     }
 
@@ -160,52 +307,16 @@ namespace wrld {
         return EnvironmentData{cpt::AmbiantLight{}, std::nullopt, 0};
     }
 
-    std::vector<PointLightData> RendererSystem::get_point_lights() const {
-        std::vector<PointLightData> res;
-
-        // Query each PointLight components in world
-        // Make sure we don't render more than 10 point lights (shader limitation)
-        auto entities = world.get_entities_with_component<cpt::PointLight>();
-        if (entities.size() > MAX_LIGHTS)
-            entities.resize(MAX_LIGHTS);
-
-        for (const auto &entity: entities) {
-            const auto cpnt = world.get_component<cpt::PointLight>(entity);
-
-            // We need the light's position. If not found, we use {0, 0, 0}.
-            glm::vec3 position{0.0};
-            if (const auto position_opt = world.get_component_opt<cpt::Transform>(entity); position_opt.has_value()) {
-                position = position_opt.value()->get_position();
-            }
-
-            res.emplace_back(position, cpnt->get_color(), cpnt->get_intensity());
-        }
-
-        return res;
+    std::span<const PointLightData> RendererSystem::get_point_lights() const {
+        // Make sure we don't render more than MAX_LIGHTS point lights (shader limitation)
+        const auto &lights = point_lights.get_items();
+        return std::span(lights).first(std::min<size_t>(lights.size(), MAX_LIGHTS));
     }
 
-    std::vector<DirectionalLightData> RendererSystem::get_directional_lights() const {
-        std::vector<DirectionalLightData> res;
-
-        // Query each DirectionalLight components in world
-        // Make sure we don't render more than 10 directional lights (shader limitation)
-        auto entities = world.get_entities_with_component<cpt::DirectionalLight>();
-        if (entities.size() > MAX_LIGHTS)
-            entities.resize(MAX_LIGHTS);
-
-        for (const auto &entity: entities) {
-            const auto cpnt = world.get_component<cpt::DirectionalLight>(entity);
-
-            // We need the light's direction. If not found, we use {0, 0, -1}.
-            glm::vec3 direction{0.0};
-            if (const auto direction_opt = world.get_component_opt<cpt::Transform>(entity); direction_opt.has_value()) {
-                direction = direction_opt.value()->get_direction();
-            }
-
-            res.emplace_back(direction, cpnt->get_color(), cpnt->get_intensity());
-        }
-
-        return res;
+    std::span<const DirectionalLightData> RendererSystem::get_directional_lights() const {
+        // Make sure we don't render more than MAX_LIGHTS directional lights (shader limitation)
+        const auto &lights = directional_lights.get_items();
+        return std::span(lights).first(std::min<size_t>(lights.size(), MAX_LIGHTS));
     }
 
     void RendererSystem::draw_skybox(const rsc::CubemapTexture &cubemap, const cpt::Camera3D &camera, GLuint vao) const {
@@ -231,16 +342,16 @@ namespace wrld {
     }
 
     void RendererSystem::draw_model(const rsc::Model &model, const glm::mat4x4 &model_matrix,
-                                    const rsc::Program &program) {
+                                    const glm::mat4x4 &normal_matrix, const rsc::Program &program) const {
         glEnable(GL_DEPTH_TEST);
         glDepthMask(GL_TRUE);
         glDepthFunc(GL_LESS);
 
-        program.set_uniform("model", model_matrix);
+        // Uploads the model again if it was evicted
+        world.get_gpu_memory().touch(model);
 
-        // Compute the model matrix specific to normals
-        const glm::mat4x4 normal_model_matrix = glm::transpose(glm::inverse(model_matrix));
-        program.set_uniform("model_normal", normal_model_matrix);
+        program.set_uniform("model", model_matrix);
+        program.set_uniform("model_normal", normal_matrix);
 
         const auto &starts = model.get_meshes_start();
         const auto &sizes = model.get_meshes_size();
@@ -12,13 +12,19 @@ namespace wrld::tools {
         const auto &entity_model = world.get_component<cpt::StaticModel>(entity);
         const auto &camera_cpt = world.get_component<cpt::Camera3D>(camera);
 
+        const auto &view = camera_cpt->get_view_matrix();
+        const auto &proj = camera_cpt->get_projection_matrix();
+
+        return is_visible(entity_model->get_model().get_ref(), model, proj * view);
+    }
+
+    bool Geometry::is_visible(const rsc::Model &model, const glm::mat4x4 &model_matrix,
+                              const glm::mat4x4 &view_projection) {
         // Local-space axis-aligned bounding box of the model
-        const auto &local_bb = entity_model->get_model()->get_local_bb();
+        const auto &local_bb = model.get_local_bb();
 
         // Convert it to projection-space
-        const auto &view = camera_cpt->get_view_matrix();
-        const auto &proj = camera_cpt->get_projection_matrix();
-        const auto trsfm = proj * view * model;
+        const auto trsfm = view_projection * model_matrix;
 
         // In projection space, the frustum is between -1 and 1 on each axis.
         // If any vertex of the bounding box is in the frustum, then the model is visible.
@@ -103,8 +103,8 @@ namespace wrld::tools {
         }
 
 
-        // Create the new models, skipping empty meshes if not necessary
-        // todo: delete those meshes (see TODO.md)
+        // Create the new models, skipping empty meshes if not necessary.
+        // Empty meshes are only referenced by the world: they are destroyed by World::collect_unused_resources.
         std::vector<Rc<rsc::Model>> new_models;
 
         for (const auto &nm: new_meshes) {